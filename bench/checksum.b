@@ -0,0 +1,57 @@
+/*
+   BLang
+   Copyright (c) 2025 William Gibbs
+
+   This software is provided 'as-is', without any express or implied
+   warranty. In no event will the authors be held liable for any damages
+   arising from the use of this software.
+
+   Permission is granted to anyone to use this software for any purpose,
+   including commercial applications, and to alter it and redistribute it
+   freely, subject to the following restrictions:
+
+   1. The origin of this software must not be misrepresented; you must not
+      claim that you wrote the original software. If you use this software
+      in a product, an acknowledgment in the product documentation would be
+      appreciated but is not required.
+   2. Altered source versions must be plainly marked as such, and must not be
+      misrepresented as being the original software.
+   3. This notice may not be removed or altered from any source distribution.
+*/
+
+/* Adler-32 style checksum over a million generated words, sixteen passes. */
+data[1048576];
+
+main() {
+   extrn data;
+   auto n, i, seed, round, a, b;
+
+   n = 1048576;
+   seed = 3;
+   i = 0;
+   while (i < n) {
+      seed = seed * 75 + 74;
+      seed = seed - seed / 65537 * 65537;
+      data[i] = seed - seed / 256 * 256;
+      i++;
+   }
+
+   a = 1;
+   b = 0;
+   round = 0;
+   while (round < 16) {
+      i = 0;
+      while (i < n) {
+         a = a + data[i];
+         a = a - a / 65521 * 65521;
+         b = b + a;
+         b = b - b / 65521 * 65521;
+         i++;
+      }
+      round++;
+   }
+
+   putnumb(b * 65536 + a);
+   putchar(10);
+   return (0);
+}
\ No newline at end of file
@@ -0,0 +1,44 @@
+/*
+   BLang
+   Copyright (c) 2025 William Gibbs
+
+   This software is provided 'as-is', without any express or implied
+   warranty. In no event will the authors be held liable for any damages
+   arising from the use of this software.
+
+   Permission is granted to anyone to use this software for any purpose,
+   including commercial applications, and to alter it and redistribute it
+   freely, subject to the following restrictions:
+
+   1. The origin of this software must not be misrepresented; you must not
+      claim that you wrote the original software. If you use this software
+      in a product, an acknowledgment in the product documentation would be
+      appreciated but is not required.
+   2. Altered source versions must be plainly marked as such, and must not be
+      misrepresented as being the original software.
+   3. This notice may not be removed or altered from any source distribution.
+*/
+
+/* C reference for checksum.b */
+#include <stdio.h>
+
+static long data[1048576];
+
+int main(void) {
+   long n = 1048576, i, seed = 3, round, a = 1, b = 0;
+
+   for (i = 0; i < n; i++) {
+      seed = (seed * 75 + 74) % 65537;
+      data[i] = seed % 256;
+   }
+
+   for (round = 0; round < 16; round++) {
+      for (i = 0; i < n; i++) {
+         a = (a + data[i]) % 65521;
+         b = (b + a) % 65521;
+      }
+   }
+
+   printf("%ld\n", b * 65536 + a);
+   return 0;
+}
\ No newline at end of file
@@ -0,0 +1,65 @@
+/*
+   BLang
+   Copyright (c) 2025 William Gibbs
+
+   This software is provided 'as-is', without any express or implied
+   warranty. In no event will the authors be held liable for any damages
+   arising from the use of this software.
+
+   Permission is granted to anyone to use this software for any purpose,
+   including commercial applications, and to alter it and redistribute it
+   freely, subject to the following restrictions:
+
+   1. The origin of this software must not be misrepresented; you must not
+      claim that you wrote the original software. If you use this software
+      in a product, an acknowledgment in the product documentation would be
+      appreciated but is not required.
+   2. Altered source versions must be plainly marked as such, and must not be
+      misrepresented as being the original software.
+   3. This notice may not be removed or altered from any source distribution.
+*/
+
+/* Multiply two 384x384 matrices of small integers and sum the weighted product. */
+a[147456];
+b[147456];
+c[147456];
+
+main() {
+   extrn a, b, c;
+   auto n, i, j, k, sum, total;
+
+   n = 384;
+   i = 0;
+   while (i < n * n) {
+      a[i] = i - i / 7 * 7;
+      b[i] = i - i / 5 * 5 - 2;
+      i++;
+   }
+
+   i = 0;
+   while (i < n) {
+      j = 0;
+      while (j < n) {
+         sum = 0;
+         k = 0;
+         while (k < n) {
+            sum = sum + a[i * n + k] * b[k * n + j];
+            k++;
+         }
+         c[i * n + j] = sum;
+         j++;
+      }
+      i++;
+   }
+
+   total = 0;
+   i = 0;
+   while (i < n * n) {
+      total = total + c[i] * (i - i / 3 * 3 + 1);
+      i++;
+   }
+
+   putnumb(total);
+   putchar(10);
+   return (0);
+}
\ No newline at end of file
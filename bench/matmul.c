@@ -0,0 +1,52 @@
+/*
+   BLang
+   Copyright (c) 2025 William Gibbs
+
+   This software is provided 'as-is', without any express or implied
+   warranty. In no event will the authors be held liable for any damages
+   arising from the use of this software.
+
+   Permission is granted to anyone to use this software for any purpose,
+   including commercial applications, and to alter it and redistribute it
+   freely, subject to the following restrictions:
+
+   1. The origin of this software must not be misrepresented; you must not
+      claim that you wrote the original software. If you use this software
+      in a product, an acknowledgment in the product documentation would be
+      appreciated but is not required.
+   2. Altered source versions must be plainly marked as such, and must not be
+      misrepresented as being the original software.
+   3. This notice may not be removed or altered from any source distribution.
+*/
+
+/* C reference for matmul.b */
+#include <stdio.h>
+
+static long a[147456];
+static long b[147456];
+static long c[147456];
+
+int main(void) {
+   long n = 384, i, j, k, sum, total;
+
+   for (i = 0; i < n * n; i++) {
+      a[i] = i % 7;
+      b[i] = i % 5 - 2;
+   }
+
+   for (i = 0; i < n; i++) {
+      for (j = 0; j < n; j++) {
+         sum = 0;
+         for (k = 0; k < n; k++)
+            sum += a[i * n + k] * b[k * n + j];
+         c[i * n + j] = sum;
+      }
+   }
+
+   total = 0;
+   for (i = 0; i < n * n; i++)
+      total += c[i] * (i % 3 + 1);
+
+   printf("%ld\n", total);
+   return 0;
+}
\ No newline at end of file
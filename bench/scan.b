@@ -0,0 +1,82 @@
+/*
+   BLang
+   Copyright (c) 2025 William Gibbs
+
+   This software is provided 'as-is', without any express or implied
+   warranty. In no event will the authors be held liable for any damages
+   arising from the use of this software.
+
+   Permission is granted to anyone to use this software for any purpose,
+   including commercial applications, and to alter it and redistribute it
+   freely, subject to the following restrictions:
+
+   1. The origin of this software must not be misrepresented; you must not
+      claim that you wrote the original software. If you use this software
+      in a product, an acknowledgment in the product documentation would be
+      appreciated but is not required.
+   2. Altered source versions must be plainly marked as such, and must not be
+      misrepresented as being the original software.
+   3. This notice may not be removed or altered from any source distribution.
+*/
+
+/* Count words, lines and the letter e in a megabyte of generated text, twenty times. */
+text[1048576];
+
+fill(n) {
+   extrn text;
+   auto i, seed, r;
+
+   seed = 1;
+   i = 0;
+   while (i < n) {
+      seed = seed * 75 + 74;
+      seed = seed - seed / 65537 * 65537;
+      r = seed - seed / 32 * 32;
+      if (r < 26) text[i] = 'a' + r;
+      else if (r < 31) text[i] = ' ';
+      else text[i] = 10;
+      i++;
+   }
+}
+
+scan(n) {
+   extrn text;
+   auto i, c, inword, words, lines, es;
+
+   words = 0;
+   lines = 0;
+   es = 0;
+   inword = 0;
+   i = 0;
+   while (i < n) {
+      c = text[i];
+      if (c == 10) {
+         lines++;
+         inword = 0;
+      } else if (c == ' ') {
+         inword = 0;
+      } else {
+         if (!inword) words++;
+         inword = 1;
+         if (c == 'e') es++;
+      }
+      i++;
+   }
+   return (words + lines * 3 + es * 7);
+}
+
+main() {
+   auto round, total;
+
+   fill(1048576);
+   total = 0;
+   round = 0;
+   while (round < 20) {
+      total = total + scan(1048576);
+      round++;
+   }
+
+   putnumb(total);
+   putchar(10);
+   return (0);
+}
\ No newline at end of file
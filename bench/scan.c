@@ -0,0 +1,67 @@
+/*
+   BLang
+   Copyright (c) 2025 William Gibbs
+
+   This software is provided 'as-is', without any express or implied
+   warranty. In no event will the authors be held liable for any damages
+   arising from the use of this software.
+
+   Permission is granted to anyone to use this software for any purpose,
+   including commercial applications, and to alter it and redistribute it
+   freely, subject to the following restrictions:
+
+   1. The origin of this software must not be misrepresented; you must not
+      claim that you wrote the original software. If you use this software
+      in a product, an acknowledgment in the product documentation would be
+      appreciated but is not required.
+   2. Altered source versions must be plainly marked as such, and must not be
+      misrepresented as being the original software.
+   3. This notice may not be removed or altered from any source distribution.
+*/
+
+/* C reference for scan.b */
+#include <stdio.h>
+
+static long text[1048576];
+
+static void fill(long n) {
+   long i, seed = 1, r;
+
+   for (i = 0; i < n; i++) {
+      seed = (seed * 75 + 74) % 65537;
+      r = seed % 32;
+      if (r < 26) text[i] = 'a' + r;
+      else if (r < 31) text[i] = ' ';
+      else text[i] = '\n';
+   }
+}
+
+static long scan(long n) {
+   long i, c, inword = 0, words = 0, lines = 0, es = 0;
+
+   for (i = 0; i < n; i++) {
+      c = text[i];
+      if (c == '\n') {
+         lines++;
+         inword = 0;
+      } else if (c == ' ') {
+         inword = 0;
+      } else {
+         if (!inword) words++;
+         inword = 1;
+         if (c == 'e') es++;
+      }
+   }
+   return words + lines * 3 + es * 7;
+}
+
+int main(void) {
+   long round, total = 0;
+
+   fill(1048576);
+   for (round = 0; round < 20; round++)
+      total += scan(1048576);
+
+   printf("%ld\n", total);
+   return 0;
+}
\ No newline at end of file
@@ -0,0 +1,63 @@
+/*
+   BLang
+   Copyright (c) 2025 William Gibbs
+
+   This software is provided 'as-is', without any express or implied
+   warranty. In no event will the authors be held liable for any damages
+   arising from the use of this software.
+
+   Permission is granted to anyone to use this software for any purpose,
+   including commercial applications, and to alter it and redistribute it
+   freely, subject to the following restrictions:
+
+   1. The origin of this software must not be misrepresented; you must not
+      claim that you wrote the original software. If you use this software
+      in a product, an acknowledgment in the product documentation would be
+      appreciated but is not required.
+   2. Altered source versions must be plainly marked as such, and must not be
+      misrepresented as being the original software.
+   3. This notice may not be removed or altered from any source distribution.
+*/
+
+/* Count the primes below 2000000 with the sieve of Eratosthenes, ten times over. */
+flags[2000000];
+
+sieve(n) {
+   extrn flags;
+   auto i, j, count;
+
+   i = 2;
+   while (i < n) {
+      flags[i] = 1;
+      i++;
+   }
+
+   count = 0;
+   i = 2;
+   while (i < n) {
+      if (flags[i]) {
+         count++;
+         j = i + i;
+         while (j < n) {
+            flags[j] = 0;
+            j = j + i;
+         }
+      }
+      i++;
+   }
+   return (count);
+}
+
+main() {
+   auto round, count;
+
+   round = 0;
+   while (round < 10) {
+      count = sieve(2000000);
+      round++;
+   }
+
+   putnumb(count);
+   putchar(10);
+   return (0);
+}
\ No newline at end of file
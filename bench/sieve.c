@@ -0,0 +1,52 @@
+/*
+   BLang
+   Copyright (c) 2025 William Gibbs
+
+   This software is provided 'as-is', without any express or implied
+   warranty. In no event will the authors be held liable for any damages
+   arising from the use of this software.
+
+   Permission is granted to anyone to use this software for any purpose,
+   including commercial applications, and to alter it and redistribute it
+   freely, subject to the following restrictions:
+
+   1. The origin of this software must not be misrepresented; you must not
+      claim that you wrote the original software. If you use this software
+      in a product, an acknowledgment in the product documentation would be
+      appreciated but is not required.
+   2. Altered source versions must be plainly marked as such, and must not be
+      misrepresented as being the original software.
+   3. This notice may not be removed or altered from any source distribution.
+*/
+
+/* C reference for sieve.b */
+#include <stdio.h>
+
+static long flags[2000000];
+
+static long sieve(long n) {
+   long i, j, count;
+
+   for (i = 2; i < n; i++)
+      flags[i] = 1;
+
+   count = 0;
+   for (i = 2; i < n; i++) {
+      if (flags[i]) {
+         count++;
+         for (j = i + i; j < n; j += i)
+            flags[j] = 0;
+      }
+   }
+   return count;
+}
+
+int main(void) {
+   long round, count = 0;
+
+   for (round = 0; round < 10; round++)
+      count = sieve(2000000);
+
+   printf("%ld\n", count);
+   return 0;
+}
\ No newline at end of file
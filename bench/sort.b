@@ -0,0 +1,74 @@
+/*
+   BLang
+   Copyright (c) 2025 William Gibbs
+
+   This software is provided 'as-is', without any express or implied
+   warranty. In no event will the authors be held liable for any damages
+   arising from the use of this software.
+
+   Permission is granted to anyone to use this software for any purpose,
+   including commercial applications, and to alter it and redistribute it
+   freely, subject to the following restrictions:
+
+   1. The origin of this software must not be misrepresented; you must not
+      claim that you wrote the original software. If you use this software
+      in a product, an acknowledgment in the product documentation would be
+      appreciated but is not required.
+   2. Altered source versions must be plainly marked as such, and must not be
+      misrepresented as being the original software.
+   3. This notice may not be removed or altered from any source distribution.
+*/
+
+/* Shell sort 200000 pseudo-random words, then check the order and sum a weighted sample. */
+v[200000];
+
+main() {
+   extrn v;
+   auto n, i, j, gap, x, seed, moving, sum, unordered;
+
+   n = 200000;
+   seed = 7;
+   i = 0;
+   while (i < n) {
+      seed = seed * 75 + 74;
+      seed = seed - seed / 65537 * 65537;
+      v[i] = seed;
+      i++;
+   }
+
+   gap = n / 2;
+   while (gap > 0) {
+      i = gap;
+      while (i < n) {
+         x = v[i];
+         j = i;
+         moving = 1;
+         while (moving) {
+            if (j < gap) moving = 0;
+            else if (v[j - gap] <= x) moving = 0;
+            else {
+               v[j] = v[j - gap];
+               j = j - gap;
+            }
+         }
+         v[j] = x;
+         i++;
+      }
+      gap = gap / 2;
+   }
+
+   sum = 0;
+   unordered = 0;
+   i = 1;
+   while (i < n) {
+      if (v[i - 1] > v[i]) unordered++;
+      sum = sum + v[i] * (i - i / 100 * 100);
+      i++;
+   }
+
+   putnumb(sum);
+   putchar(' ');
+   putnumb(unordered);
+   putchar(10);
+   return (0);
+}
\ No newline at end of file
@@ -0,0 +1,53 @@
+/*
+   BLang
+   Copyright (c) 2025 William Gibbs
+
+   This software is provided 'as-is', without any express or implied
+   warranty. In no event will the authors be held liable for any damages
+   arising from the use of this software.
+
+   Permission is granted to anyone to use this software for any purpose,
+   including commercial applications, and to alter it and redistribute it
+   freely, subject to the following restrictions:
+
+   1. The origin of this software must not be misrepresented; you must not
+      claim that you wrote the original software. If you use this software
+      in a product, an acknowledgment in the product documentation would be
+      appreciated but is not required.
+   2. Altered source versions must be plainly marked as such, and must not be
+      misrepresented as being the original software.
+   3. This notice may not be removed or altered from any source distribution.
+*/
+
+/* C reference for sort.b */
+#include <stdio.h>
+
+static long v[200000];
+
+int main(void) {
+   long n = 200000, i, j, gap, x, seed = 7, sum, unordered;
+
+   for (i = 0; i < n; i++) {
+      seed = (seed * 75 + 74) % 65537;
+      v[i] = seed;
+   }
+
+   for (gap = n / 2; gap > 0; gap /= 2) {
+      for (i = gap; i < n; i++) {
+         x = v[i];
+         for (j = i; j >= gap && v[j - gap] > x; j -= gap)
+            v[j] = v[j - gap];
+         v[j] = x;
+      }
+   }
+
+   sum = 0;
+   unordered = 0;
+   for (i = 1; i < n; i++) {
+      if (v[i - 1] > v[i]) unordered++;
+      sum += v[i] * (i % 100);
+   }
+
+   printf("%ld %ld\n", sum, unordered);
+   return 0;
+}
\ No newline at end of file
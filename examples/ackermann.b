@@ -0,0 +1,33 @@
+/*
+   BLang
+   Copyright (c) 2025 William Gibbs
+
+   This software is provided 'as-is', without any express or implied
+   warranty. In no event will the authors be held liable for any damages
+   arising from the use of this software.
+
+   Permission is granted to anyone to use this software for any purpose,
+   including commercial applications, and to alter it and redistribute it
+   freely, subject to the following restrictions:
+
+   1. The origin of this software must not be misrepresented; you must not
+      claim that you wrote the original software. If you use this software
+      in a product, an acknowledgment in the product documentation would be
+      appreciated but is not required.
+   2. Altered source versions must be plainly marked as such, and must not be
+      misrepresented as being the original software.
+   3. This notice may not be removed or altered from any source distribution.
+*/
+
+
+/* The last two returns call ack() in tail position, so they reuse its frame. */
+ack(m, n) {
+   if (m == 0) return (n + 1);
+   if (n == 0) return (ack(m - 1, 1));
+   return (ack(m - 1, ack(m, n - 1)));
+}
+
+main() {
+   putnumb(ack(2, 100000));
+   putchar(10);
+}
\ No newline at end of file
@@ -0,0 +1,52 @@
+/*
+   BLang
+   Copyright (c) 2025 William Gibbs
+
+   This software is provided 'as-is', without any express or implied
+   warranty. In no event will the authors be held liable for any damages
+   arising from the use of this software.
+
+   Permission is granted to anyone to use this software for any purpose,
+   including commercial applications, and to alter it and redistribute it
+   freely, subject to the following restrictions:
+
+   1. The origin of this software must not be misrepresented; you must not
+      claim that you wrote the original software. If you use this software
+      in a product, an acknowledgment in the product documentation would be
+      appreciated but is not required.
+   2. Altered source versions must be plainly marked as such, and must not be
+      misrepresented as being the original software.
+   3. This notice may not be removed or altered from any source distribution.
+*/
+
+
+/* Sum, copy and scale loops, which -O2 should turn into SIMD code. */
+a[1024];
+b[1024];
+
+main() {
+   extrn a, b;
+   auto i, sum;
+
+   i = 0;
+   while (i < 1024) {
+      a[i] = i;
+      i++;
+   }
+
+   i = 0;
+   while (i < 1024) {
+      b[i] = a[i] * 3;
+      i++;
+   }
+
+   sum = 0;
+   i = 0;
+   while (i < 1024) {
+      sum = sum + b[i];
+      i++;
+   }
+
+   putnumb(sum);
+   putchar(10);
+}
\ No newline at end of file
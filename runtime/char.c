@@ -0,0 +1,40 @@
+/*
+   BLang
+   Copyright (c) 2025 William Gibbs
+
+   This software is provided 'as-is', without any express or implied
+   warranty. In no event will the authors be held liable for any damages
+   arising from the use of this software.
+
+   Permission is granted to anyone to use this software for any purpose,
+   including commercial applications, and to alter it and redistribute it
+   freely, subject to the following restrictions:
+
+   1. The origin of this software must not be misrepresented; you must not
+      claim that you wrote the original software. If you use this software
+      in a product, an acknowledgment in the product documentation would be
+      appreciated but is not required.
+   2. Altered source versions must be plainly marked as such, and must not be
+      misrepresented as being the original software.
+   3. This notice may not be removed or altered from any source distribution.
+*/
+
+/*
+ * putchar and getchar, the calls B programs make once per character. This
+ * file is compiled both into the runtime archive and to blang-rt.bc, which
+ * the compiler links into optimized programs so these inline; the slow
+ * paths they fall back on stay in io.c.
+ */
+
+#include "io.h"
+
+long putchar(long c) {
+   if (__builtin_expect(__blang_out_used == BLANG_BUFFER_SIZE, 0)) __blang_out_flush();
+   __blang_out[__blang_out_used++] = (char)c;
+   return c;
+}
+
+long getchar(void) {
+   if (__builtin_expect(__blang_in_next < __blang_in_end, 1)) return __blang_in[__blang_in_next++];
+   return __blang_in_fill();
+}
\ No newline at end of file
@@ -0,0 +1,160 @@
+/*
+   BLang
+   Copyright (c) 2025 William Gibbs
+
+   This software is provided 'as-is', without any express or implied
+   warranty. In no event will the authors be held liable for any damages
+   arising from the use of this software.
+
+   Permission is granted to anyone to use this software for any purpose,
+   including commercial applications, and to alter it and redistribute it
+   freely, subject to the following restrictions:
+
+   1. The origin of this software must not be misrepresented; you must not
+      claim that you wrote the original software. If you use this software
+      in a product, an acknowledgment in the product documentation would be
+      appreciated but is not required.
+   2. Altered source versions must be plainly marked as such, and must not be
+      misrepresented as being the original software.
+   3. This notice may not be removed or altered from any source distribution.
+*/
+
+/*
+ * The B library's I/O: standard input and output through 64 KiB buffers,
+ * printf, putnumb, and the read and write system calls. Output is flushed
+ * when the buffer fills, before reading input or writing to a descriptor
+ * directly, and when main() returns.
+ */
+
+#include "io.h"
+#include "syscall.h"
+
+#define EOT 4   // B's end of file and string terminator, *e
+
+char __blang_out[BLANG_BUFFER_SIZE];
+unsigned long __blang_out_used;
+
+unsigned char __blang_in[BLANG_BUFFER_SIZE];
+unsigned long __blang_in_next;
+unsigned long __blang_in_end;
+
+void __blang_out_flush(void) {
+   unsigned long done = 0;
+   while (done < __blang_out_used) {
+      long n = rt_write(1, __blang_out + done, __blang_out_used - done);
+      if (n <= 0) break;
+      done += n;
+   }
+   __blang_out_used = 0;
+}
+
+long __blang_in_fill(void) {
+   __blang_out_flush();   // a prompt must appear before the program waits on input
+
+   long n = rt_read(0, __blang_in, BLANG_BUFFER_SIZE);
+   if (n <= 0) {
+      __blang_in_next = __blang_in_end = 0;
+      return EOT;
+   }
+   __blang_in_next = 1;
+   __blang_in_end = n;
+   return __blang_in[0];
+}
+
+// Called on the way out of main().
+void __blang_flush(void) {
+   __blang_out_flush();
+}
+
+static void put_bytes(const char* text, unsigned long length) {
+   while (length) {
+      if (__blang_out_used == BLANG_BUFFER_SIZE) __blang_out_flush();
+      unsigned long room = BLANG_BUFFER_SIZE - __blang_out_used;
+      unsigned long n = length < room ? length : room;
+      for (unsigned long i = 0; i < n; i++) __blang_out[__blang_out_used + i] = text[i];
+      __blang_out_used += n;
+      text += n;
+      length -= n;
+   }
+}
+
+static void put_number(long value, unsigned base) {
+   char digits[24];
+   int n = 0;
+   unsigned long magnitude = (unsigned long)value;
+
+   if (base == 10 && value < 0) magnitude = -magnitude;
+   do {
+      digits[sizeof(digits) - ++n] = (char)('0' + magnitude % base);
+      magnitude /= base;
+   } while (magnitude);
+   if (base == 10 && value < 0) digits[sizeof(digits) - ++n] = '-';
+
+   put_bytes(digits + sizeof(digits) - n, n);
+}
+
+// B strings end in *e; a NUL ends them too, for strings made by C.
+static void put_string(const char* text) {
+   unsigned long length = 0;
+   while (text[length] && text[length] != EOT) length++;
+   put_bytes(text, length);
+}
+
+long putnumb(long n) {
+   put_number(n, 10);
+   return n;
+}
+
+/**
+ * printf(format, a1, ..., a9) with B's %d, %o, %c and %s. The arguments are
+ * fixed rather than variadic: B passes every argument as a word, and a plain
+ * prototype is called the same way under every ABI.
+ */
+long printf(long format, long a1, long a2, long a3, long a4, long a5, long a6, long a7, long a8, long a9) {
+   long args[] = { a1, a2, a3, a4, a5, a6, a7, a8, a9 };
+   unsigned next = 0;
+
+   for (const char* f = (const char*)format; *f && *f != EOT; f++) {
+      if (*f != '%' || !f[1]) {
+         put_bytes(f, 1);
+         continue;
+      }
+
+      char conversion = *++f;
+      if (conversion == '%') {
+         put_bytes(f, 1);
+         continue;
+      }
+
+      long arg = next < sizeof(args) / sizeof(args[0]) ? args[next++] : 0;
+      switch (conversion) {
+         case 'd': put_number(arg, 10); break;
+         case 'o': put_number(arg, 8); break;
+         case 'c': { char c = (char)arg; put_bytes(&c, 1); break; }
+         case 's': put_string((const char*)arg); break;
+         default:  put_bytes(f - 1, 2); break;
+      }
+   }
+   return 0;
+}
+
+long write(long fd, long buffer, long count) {
+   if (fd == 1 || fd == 2) __blang_out_flush();
+   return rt_write((int)fd, (const void*)buffer, (unsigned long)count);
+}
+
+long read(long fd, long buffer, long count) {
+   if (fd != 0) return rt_read((int)fd, (void*)buffer, (unsigned long)count);
+
+   // Hand out what getchar() has buffered before asking the kernel.
+   if (__blang_in_next < __blang_in_end) {
+      unsigned long available = __blang_in_end - __blang_in_next;
+      unsigned long n = (unsigned long)count < available ? (unsigned long)count : available;
+      for (unsigned long i = 0; i < n; i++) ((char*)buffer)[i] = (char)__blang_in[__blang_in_next + i];
+      __blang_in_next += n;
+      return (long)n;
+   }
+
+   __blang_out_flush();
+   return rt_read(0, (void*)buffer, (unsigned long)count);
+}
\ No newline at end of file
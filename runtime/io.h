@@ -0,0 +1,53 @@
+/*
+   BLang
+   Copyright (c) 2025 William Gibbs
+
+   This software is provided 'as-is', without any express or implied
+   warranty. In no event will the authors be held liable for any damages
+   arising from the use of this software.
+
+   Permission is granted to anyone to use this software for any purpose,
+   including commercial applications, and to alter it and redistribute it
+   freely, subject to the following restrictions:
+
+   1. The origin of this software must not be misrepresented; you must not
+      claim that you wrote the original software. If you use this software
+      in a product, an acknowledgment in the product documentation would be
+      appreciated but is not required.
+   2. Altered source versions must be plainly marked as such, and must not be
+      misrepresented as being the original software.
+   3. This notice may not be removed or altered from any source distribution.
+*/
+
+#ifndef BLANG_RT_IO_H
+#define BLANG_RT_IO_H
+
+/*
+ * Buffered standard input and output. The buffers live in io.c, and the
+ * single-character fast paths in char.c, which the compiler also links
+ * into programs as bitcode so they inline into their callers. Everything
+ * here is hidden: it is shared by the runtime and the program it is
+ * linked into, never exported.
+ */
+
+#define BLANG_BUFFER_SIZE (64 * 1024)
+
+#pragma GCC visibility push(hidden)
+
+extern char __blang_out[BLANG_BUFFER_SIZE];
+extern unsigned long __blang_out_used;
+
+extern unsigned char __blang_in[BLANG_BUFFER_SIZE];
+extern unsigned long __blang_in_next;
+extern unsigned long __blang_in_end;
+
+// Write out everything buffered for standard output.
+void __blang_out_flush(void);
+
+// Refill the input buffer and return its first character, or B's end of
+// file (ASCII EOT) once input is exhausted.
+long __blang_in_fill(void);
+
+#pragma GCC visibility pop
+
+#endif // BLANG_RT_IO_H
\ No newline at end of file
@@ -0,0 +1,102 @@
+/*
+   BLang
+   Copyright (c) 2025 William Gibbs
+
+   This software is provided 'as-is', without any express or implied
+   warranty. In no event will the authors be held liable for any damages
+   arising from the use of this software.
+
+   Permission is granted to anyone to use this software for any purpose,
+   including commercial applications, and to alter it and redistribute it
+   freely, subject to the following restrictions:
+
+   1. The origin of this software must not be misrepresented; you must not
+      claim that you wrote the original software. If you use this software
+      in a product, an acknowledgment in the product documentation would be
+      appreciated but is not required.
+   2. Altered source versions must be plainly marked as such, and must not be
+      misrepresented as being the original software.
+   3. This notice may not be removed or altered from any source distribution.
+*/
+
+/*
+ * Writes the counters of a -fprofile-generate program when it exits, in
+ * the format of src/profile.h. The compiler puts one descriptor per
+ * function in the blang_prof_data section, and the linker brackets the
+ * section with __start_ and __stop_ symbols. Programs built without
+ * instrumentation have neither, and write nothing.
+ */
+
+#include "syscall.h"
+
+typedef struct {
+   const char* name;
+   unsigned long length;
+   unsigned long hash;
+   unsigned long count;
+   const unsigned long* counters;
+} ProfileData;
+
+extern const ProfileData __start_blang_prof_data[] __attribute__((weak));
+extern const ProfileData __stop_blang_prof_data[] __attribute__((weak));
+extern const char __blang_profile_path[] __attribute__((weak));
+
+typedef struct {
+   int fd;
+   unsigned long used;
+   char data[4096];
+} Output;
+
+static void flush(Output* out) {
+   unsigned long done = 0;
+   while (done < out->used) {
+      long n = rt_write(out->fd, out->data + done, out->used - done);
+      if (n <= 0) break;
+      done += n;
+   }
+   out->used = 0;
+}
+
+static void put(Output* out, const char* text, unsigned long length) {
+   for (unsigned long i = 0; i < length; i++) {
+      if (out->used == sizeof(out->data)) flush(out);
+      out->data[out->used++] = text[i];
+   }
+}
+
+static void put_number(Output* out, unsigned long value) {
+   char digits[20];
+   int n = 0;
+   do {
+      digits[sizeof(digits) - ++n] = (char)('0' + value % 10);
+      value /= 10;
+   } while (value);
+   put(out, digits + sizeof(digits) - n, n);
+}
+
+void __blang_profile_write(void) {
+   const ProfileData* begin = __start_blang_prof_data;
+   const ProfileData* end = __stop_blang_prof_data;
+   if (!__blang_profile_path || begin == end) return;
+
+   Output out;
+   out.fd = rt_create(__blang_profile_path);
+   out.used = 0;
+   if (out.fd < 0) return;
+
+   for (const ProfileData* data = begin; data < end; data++) {
+      put(&out, data->name, data->length);
+      put(&out, " ", 1);
+      put_number(&out, data->hash);
+      put(&out, " ", 1);
+      put_number(&out, data->count);
+      for (unsigned long i = 0; i < data->count; i++) {
+         put(&out, " ", 1);
+         put_number(&out, data->counters[i]);
+      }
+      put(&out, "\n", 1);
+   }
+
+   flush(&out);
+   rt_close(out.fd);
+}
\ No newline at end of file
@@ -0,0 +1,131 @@
+/*
+   BLang
+   Copyright (c) 2025 William Gibbs
+
+   This software is provided 'as-is', without any express or implied
+   warranty. In no event will the authors be held liable for any damages
+   arising from the use of this software.
+
+   Permission is granted to anyone to use this software for any purpose,
+   including commercial applications, and to alter it and redistribute it
+   freely, subject to the following restrictions:
+
+   1. The origin of this software must not be misrepresented; you must not
+      claim that you wrote the original software. If you use this software
+      in a product, an acknowledgment in the product documentation would be
+      appreciated but is not required.
+   2. Altered source versions must be plainly marked as such, and must not be
+      misrepresented as being the original software.
+   3. This notice may not be removed or altered from any source distribution.
+*/
+
+/*
+ * Program entry for B executables. The kernel jumps to _start with the
+ * stack holding argc, then argv. Executables are static: position
+ * dependent ones run as linked, and static PIEs are relocated here
+ * before anything else runs, since there is no dynamic loader to do it.
+ */
+
+#include "syscall.h"
+
+// Everything here must be reached PC-relative, before relocation.
+#pragma GCC visibility push(hidden)
+
+typedef struct {
+   long tag;
+   unsigned long value;
+} ElfDyn;
+
+typedef struct {
+   unsigned long offset;
+   unsigned long info;
+   long addend;
+} ElfRela;
+
+#define DT_NULL     0
+#define DT_RELA     7
+#define DT_RELASZ   8
+
+#if defined(__x86_64__)
+#define R_RELATIVE  8
+#else
+#define R_RELATIVE  1027
+#endif
+
+extern const char __ehdr_start[];   // defined by the linker, at the load address
+
+#pragma GCC visibility pop
+
+extern long main(long argc, char** argv);
+extern void __blang_flush(void);
+extern void __blang_profile_write(void);
+
+/**
+ * Apply R_*_RELATIVE relocations. A static PIE has no other kind: every
+ * symbol is defined in the executable, so the linker resolved them all
+ * to offsets from the load address. _start passes in _DYNAMIC (NULL when
+ * position dependent) because a weak reference from C would itself be
+ * loaded from the GOT, which is not relocated yet.
+ */
+static void relocate(const ElfDyn* dynamic) {
+   if (!dynamic) return;
+
+   unsigned long base = (unsigned long)__ehdr_start;
+   const ElfRela* rela = 0;
+   unsigned long size = 0;
+
+   for (const ElfDyn* entry = dynamic; entry->tag != DT_NULL; entry++) {
+      if (entry->tag == DT_RELA) rela = (const ElfRela*)(base + entry->value);
+      else if (entry->tag == DT_RELASZ) size = entry->value;
+   }
+
+   for (unsigned long i = 0; i < size / sizeof(ElfRela); i++)
+      if ((rela[i].info & 0xffffffff) == R_RELATIVE)
+         *(unsigned long*)(base + rela[i].offset) = base + rela[i].addend;
+}
+
+__attribute__((used, noreturn)) void __blang_start(long* stack, const ElfDyn* dynamic) {
+   relocate(dynamic);
+
+   long argc = stack[0];
+   char** argv = (char**)(stack + 1);
+
+   long status = main(argc, argv);
+   __blang_flush();
+   __blang_profile_write();
+   rt_exit((int)status);
+}
+
+#if defined(__x86_64__)
+__asm__(
+   ".text\n"
+   ".global _start\n"
+   ".type _start, @function\n"
+   ".weak _DYNAMIC\n"
+   ".hidden _DYNAMIC\n"
+   "_start:\n"
+   "   xor %rbp, %rbp\n"
+   "   mov %rsp, %rdi\n"
+   "   lea _DYNAMIC(%rip), %rsi\n"
+   "   and $-16, %rsp\n"
+   "   call __blang_start\n"
+   "   hlt\n"
+);
+#else
+__asm__(
+   ".text\n"
+   ".global _start\n"
+   ".type _start, %function\n"
+   ".weak _DYNAMIC\n"
+   ".hidden _DYNAMIC\n"
+   "_start:\n"
+   "   mov x29, #0\n"
+   "   mov x30, #0\n"
+   "   mov x0, sp\n"
+   "   adrp x1, _DYNAMIC\n"
+   "   add x1, x1, :lo12:_DYNAMIC\n"
+   "   and sp, x0, #-16\n"
+   "   bl __blang_start\n"
+   "   brk #0\n"
+);
+#endif
\ No newline at end of file
@@ -0,0 +1,115 @@
+/*
+   BLang
+   Copyright (c) 2025 William Gibbs
+
+   This software is provided 'as-is', without any express or implied
+   warranty. In no event will the authors be held liable for any damages
+   arising from the use of this software.
+
+   Permission is granted to anyone to use this software for any purpose,
+   including commercial applications, and to alter it and redistribute it
+   freely, subject to the following restrictions:
+
+   1. The origin of this software must not be misrepresented; you must not
+      claim that you wrote the original software. If you use this software
+      in a product, an acknowledgment in the product documentation would be
+      appreciated but is not required.
+   2. Altered source versions must be plainly marked as such, and must not be
+      misrepresented as being the original software.
+   3. This notice may not be removed or altered from any source distribution.
+*/
+
+#ifndef BLANG_RT_SYSCALL_H
+#define BLANG_RT_SYSCALL_H
+
+/*
+ * Raw Linux system calls. The runtime does not use a C library, so these
+ * are the only way it talks to the kernel.
+ */
+
+#if defined(__x86_64__)
+#define SYS_read        0
+#define SYS_write       1
+#define SYS_close       3
+#define SYS_openat      257
+#define SYS_exit_group  231
+#elif defined(__aarch64__)
+#define SYS_read        63
+#define SYS_write       64
+#define SYS_close       57
+#define SYS_openat      56
+#define SYS_exit_group  94
+#else
+#error "the B runtime supports x86_64 and aarch64 Linux"
+#endif
+
+#define AT_FDCWD        -100
+#define O_WRONLY        01
+#define O_CREAT         0100
+#define O_TRUNC         01000
+
+static inline long rt_syscall4(long number, long a, long b, long c, long d) {
+#if defined(__x86_64__)
+   long result;
+   register long r10 __asm__("r10") = d;
+   __asm__ volatile ("syscall"
+      : "=a"(result)
+      : "a"(number), "D"(a), "S"(b), "d"(c), "r"(r10)
+      : "rcx", "r11", "memory");
+   return result;
+#else
+   register long x8 __asm__("x8") = number;
+   register long x0 __asm__("x0") = a;
+   register long x1 __asm__("x1") = b;
+   register long x2 __asm__("x2") = c;
+   register long x3 __asm__("x3") = d;
+   __asm__ volatile ("svc 0"
+      : "+r"(x0)
+      : "r"(x8), "r"(x1), "r"(x2), "r"(x3)
+      : "memory");
+   return x0;
+#endif
+}
+
+static inline long rt_syscall3(long number, long a, long b, long c) {
+#if defined(__x86_64__)
+   long result;
+   __asm__ volatile ("syscall"
+      : "=a"(result)
+      : "a"(number), "D"(a), "S"(b), "d"(c)
+      : "rcx", "r11", "memory");
+   return result;
+#else
+   register long x8 __asm__("x8") = number;
+   register long x0 __asm__("x0") = a;
+   register long x1 __asm__("x1") = b;
+   register long x2 __asm__("x2") = c;
+   __asm__ volatile ("svc 0"
+      : "+r"(x0)
+      : "r"(x8), "r"(x1), "r"(x2)
+      : "memory");
+   return x0;
+#endif
+}
+
+static inline long rt_read(int fd, void* buffer, unsigned long length) {
+   return rt_syscall3(SYS_read, fd, (long)buffer, (long)length);
+}
+
+static inline long rt_write(int fd, const void* buffer, unsigned long length) {
+   return rt_syscall3(SYS_write, fd, (long)buffer, (long)length);
+}
+
+static inline int rt_create(const char* path) {
+   return (int)rt_syscall4(SYS_openat, AT_FDCWD, (long)path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+}
+
+static inline void rt_close(int fd) {
+   rt_syscall3(SYS_close, fd, 0, 0);
+}
+
+__attribute__((noreturn)) static inline void rt_exit(int status) {
+   for (;;) rt_syscall3(SYS_exit_group, status, 0, 0);
+}
+
+#endif // BLANG_RT_SYSCALL_H
\ No newline at end of file
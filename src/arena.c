@@ -0,0 +1,99 @@
+/*
+   BLang
+   Copyright (c) 2025 William Gibbs
+
+   This software is provided 'as-is', without any express or implied
+   warranty. In no event will the authors be held liable for any damages
+   arising from the use of this software.
+
+   Permission is granted to anyone to use this software for any purpose,
+   including commercial applications, and to alter it and redistribute it
+   freely, subject to the following restrictions:
+
+   1. The origin of this software must not be misrepresented; you must not
+      claim that you wrote the original software. If you use this software
+      in a product, an acknowledgment in the product documentation would be
+      appreciated but is not required.
+   2. Altered source versions must be plainly marked as such, and must not be
+      misrepresented as being the original software.
+   3. This notice may not be removed or altered from any source distribution.
+*/
+
+#include "arena.h"
+#include "error.h"
+#include "opt.h"
+#include <stdalign.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define SLAB_SIZE (64 * 1024)
+#define ARENA_ALIGN alignof(max_align_t)
+
+typedef struct Slab {
+    struct Slab* previous;
+    size_t size;
+    size_t used;
+    alignas(max_align_t) unsigned char data[];
+} Slab;
+
+static Slab* current_slab = NULL;
+static size_t bytes_reserved = 0;
+static size_t bytes_used = 0;
+static size_t slab_count = 0;
+
+GCC_COLD static Slab* new_slab(size_t size) {
+    // calloc() hands back fresh zeroed pages, so nodes never start out with garbage.
+    Slab* slab = calloc(1, sizeof(Slab) + size);
+    if (GCC_UNLIKELY(!slab)) fatal_error("failed to allocate %zu bytes for the AST arena.", size);
+    slab->size = size;
+    bytes_reserved += sizeof(Slab) + size;
+    slab_count++;
+    return slab;
+}
+
+void* arena_alloc(size_t size) {
+    size = (size + ARENA_ALIGN - 1) & ~(ARENA_ALIGN - 1);
+
+    if (GCC_UNLIKELY(!current_slab || current_slab->used + size > current_slab->size)) {
+        // Oversized requests get a slab of their own, which is linked in behind the
+        // current one so the remaining space of the current slab is not wasted.
+        if (size > SLAB_SIZE / 4 && current_slab) {
+            Slab* slab = new_slab(size);
+            slab->used = size;
+            slab->previous = current_slab->previous;
+            current_slab->previous = slab;
+            bytes_used += size;
+            return slab->data;
+        }
+        Slab* slab = new_slab(size > SLAB_SIZE ? size : SLAB_SIZE);
+        slab->previous = current_slab;
+        current_slab = slab;
+    }
+
+    void* ptr = current_slab->data + current_slab->used;
+    current_slab->used += size;
+    bytes_used += size;
+    return ptr;
+}
+
+char* arena_strdup(const char* text, size_t length) {
+    char* copy = arena_alloc(length + 1);
+    memcpy(copy, text, length);
+    copy[length] = '\0';
+    return copy;
+}
+
+void arena_release(void) {
+    while (current_slab) {
+        Slab* previous = current_slab->previous;
+        free(current_slab);
+        current_slab = previous;
+    }
+    bytes_reserved = 0;
+    bytes_used = 0;
+    slab_count = 0;
+}
+
+size_t arena_bytes_reserved(void) { return bytes_reserved; }
+size_t arena_bytes_used(void) { return bytes_used; }
+size_t arena_slab_count(void) { return slab_count; }
\ No newline at end of file
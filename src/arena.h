@@ -0,0 +1,49 @@
+/*
+   BLang
+   Copyright (c) 2025 William Gibbs
+
+   This software is provided 'as-is', without any express or implied
+   warranty. In no event will the authors be held liable for any damages
+   arising from the use of this software.
+
+   Permission is granted to anyone to use this software for any purpose,
+   including commercial applications, and to alter it and redistribute it
+   freely, subject to the following restrictions:
+
+   1. The origin of this software must not be misrepresented; you must not
+      claim that you wrote the original software. If you use this software
+      in a product, an acknowledgment in the product documentation would be
+      appreciated but is not required.
+   2. Altered source versions must be plainly marked as such, and must not be
+      misrepresented as being the original software.
+   3. This notice may not be removed or altered from any source distribution.
+*/
+
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * A bump-pointer arena made of chunked slabs. Everything the parser builds
+ * (AST nodes and identifier strings) is carved out of it, and the whole lot
+ * is handed back in one go by arena_release() once code generation is done.
+ * Memory returned by arena_alloc() is always zeroed.
+ */
+void* arena_alloc(size_t size);
+char* arena_strdup(const char* text, size_t length);
+void arena_release(void);
+
+size_t arena_bytes_reserved(void);
+size_t arena_bytes_used(void);
+size_t arena_slab_count(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // ARENA_H
\ No newline at end of file
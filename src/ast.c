@@ -20,21 +20,145 @@
 */
 
 #include "ast.h"
+#include "arena.h"
 #include "error.h"
+#include "opt.h"
+#include <stdbool.h>
 #include <stdlib.h>
 #include <stdio.h>
+#include <string.h>
 
-ASTNode** generated_ast = NULL;
-int ast_length = 0;
+ASTNode* ast_nodes = NULL;
+uint32_t ast_node_count = 0;
+static uint32_t ast_node_capacity = 0;
 
-void append_statement(ASTNode* node) {
-    generated_ast = realloc(generated_ast, sizeof(ASTNode*) * (ast_length + 1));
-    if (!generated_ast) {
-        perror("realloc failed");
-        exit(EXIT_FAILURE);
+uint32_t* ast_lists = NULL;
+uint32_t ast_list_words = 0;
+static uint32_t ast_list_capacity = 0;
+
+// High-water marks across the definitions of a file, for -v.
+static uint32_t ast_node_peak = 0;
+static uint32_t ast_list_peak = 0;
+
+static ASTIndex* scratch = NULL;
+static uint32_t scratch_length = 0;
+static uint32_t scratch_capacity = 0;
+
+// Grow an array geometrically so that it can hold at least `needed` elements.
+GCC_COLD static void* grow(void* array, uint32_t* capacity, uint32_t needed, size_t size) {
+    uint32_t grown = *capacity ? *capacity : 256;
+    while (grown < needed) grown *= 2;
+    array = realloc(array, size * grown);
+    if (GCC_UNLIKELY(!array)) fatal_error("failed to allocate space for the AST.");
+    *capacity = grown;
+    return array;
+}
+
+// Word 0 is the length of the shared empty list.
+GCC_COLD static void reserve_empty_list() {
+    ast_lists = grow(ast_lists, &ast_list_capacity, 2, sizeof(uint32_t));
+    ast_lists[ast_list_words++] = 0;
+}
+
+ASTIndex ast_new_node(ASTNodeType type) {
+    if (GCC_UNLIKELY(ast_node_count + 1 > ast_node_capacity)) {
+        bool first = ast_nodes == NULL;
+        ast_nodes = grow(ast_nodes, &ast_node_capacity, ast_node_count + 2, sizeof(ASTNode));
+        // Slot 0 is the STOP node every "missing" child refers to.
+        if (first) ast_nodes[ast_node_count++] = (ASTNode){ .type = STOP };
+        // Any node may hold the empty list, even in a tree that has no other list yet.
+        if (!ast_lists) reserve_empty_list();
     }
-    generated_ast[ast_length] = node;
-    ast_length++;
+    ASTIndex index = ast_node_count++;
+    ast_nodes[index] = (ASTNode){ .type = type };
+    return index;
+}
+
+ASTIndex ast_new_binary(ASTNodeType type, ASTIndex left, ASTIndex right) {
+    ASTIndex index = ast_new_node(type);
+    ast_nodes[index].factors.left = left;
+    ast_nodes[index].factors.right = right;
+    return index;
+}
+
+static ASTList reserve_list(uint32_t length) {
+    if (GCC_UNLIKELY(ast_list_words + length + 1 > ast_list_capacity))
+        ast_lists = grow(ast_lists, &ast_list_capacity, ast_list_words + length + 1, sizeof(uint32_t));
+    ASTList list = ast_list_words;
+    ast_lists[list] = length;
+    ast_list_words += length + 1;
+    return list;
+}
+
+uint32_t ast_list_begin() {
+    return scratch_length;
+}
+
+void ast_list_push(ASTIndex item) {
+    if (GCC_UNLIKELY(scratch_length + 1 > scratch_capacity))
+        scratch = grow(scratch, &scratch_capacity, scratch_length + 1, sizeof(ASTIndex));
+    scratch[scratch_length++] = item;
+}
+
+ASTList ast_list_end(uint32_t mark) {
+    uint32_t length = scratch_length - mark;
+    if (length == 0) return 0;
+
+    ASTList list = reserve_list(length);
+    for (uint32_t i = 0; i < length; i++)
+        ast_lists[list + 1 + i] = scratch[mark + i];
+    scratch_length = mark;
+    return list;
+}
+
+ASTList ast_list_update(uint32_t mark, ASTList list) {
+    uint32_t length = scratch_length - mark;
+    if (length == ast_list_length(list) &&
+        (length == 0 || memcmp(&scratch[mark], ast_list_items(list), length * sizeof(ASTIndex)) == 0)) {
+        scratch_length = mark;
+        return list;
+    }
+    return ast_list_end(mark);
+}
+
+ASTList ast_list_of(ASTIndex item) {
+    ASTList list = reserve_list(1);
+    ast_lists[list + 1] = item;
+    return list;
+}
+
+void ast_recycle() {
+    if (ast_node_count > ast_node_peak) ast_node_peak = ast_node_count;
+    if (ast_list_words > ast_list_peak) ast_list_peak = ast_list_words;
+
+    // Slot 0 and word 0 stay: the STOP node and the empty list.
+    if (ast_nodes) ast_node_count = 1;
+    if (ast_lists) ast_list_words = 1;
+}
+
+void ast_release() {
+    free(ast_nodes);
+    free(ast_lists);
+    free(scratch);
+    ast_nodes = NULL;
+    ast_lists = NULL;
+    scratch = NULL;
+    ast_node_count = ast_node_capacity = 0;
+    ast_list_words = ast_list_capacity = 0;
+    scratch_length = scratch_capacity = 0;
+    ast_node_peak = ast_list_peak = 0;
+    symtab_release();
+    arena_release();
+}
+
+void print_ast_stats() {
+    uint32_t nodes = ast_node_count > ast_node_peak ? ast_node_count : ast_node_peak;
+    uint32_t words = ast_list_words > ast_list_peak ? ast_list_words : ast_list_peak;
+    fprintf(stderr,
+        "blang: AST: peak %u nodes (%zu bytes), %u list words (%zu bytes), arena: %zu bytes used, %zu bytes reserved in %zu slabs\n",
+        nodes, nodes * sizeof(ASTNode),
+        words, words * sizeof(uint32_t),
+        arena_bytes_used(), arena_bytes_reserved(), arena_slab_count());
 }
 
 static inline void print_indent(int depth) {
@@ -42,13 +166,39 @@ static inline void print_indent(int depth) {
     for (int i = 0; i < depth; i++) printf("\t");
 }
 
-static inline void print_node(ASTNode* node, int depth) {
-    if (!node) { print_indent(depth); printf("NODE IS NULL\n"); return; }
+/*
+ * The tree is printed from an explicit stack rather than by recursion, so
+ * expressions nested a hundred thousand deep print as well as they compile.
+ * A node prints its own lines and queues its children, last child first.
+ */
+typedef struct PrintItem {
+    ASTIndex index;
+    int depth;
+} PrintItem;
+
+static PrintItem* printing = NULL;
+static uint32_t printing_length = 0;
+static uint32_t printing_capacity = 0;
+
+static void print_later(ASTIndex index, int depth) {
+    if (GCC_UNLIKELY(printing_length + 1 > printing_capacity))
+        printing = grow(printing, &printing_capacity, printing_length + 1, sizeof(PrintItem));
+    printing[printing_length++] = (PrintItem){ index, depth };
+}
+
+static void print_list(ASTList list, int depth) {
+    const ASTIndex* items = ast_list_items(list);
+    for (uint32_t i = ast_list_length(list); i > 0; i--)
+        print_later(items[i - 1], depth);
+}
+
+static void print_node(ASTIndex index, int depth) {
+    ASTNode* node = ast_node(index);
 
     if (node->type == STOP) return;
 
     print_indent(depth);
-    if (node->type >= 0 && node->type < sizeof(ASTNodeTypeNames)/sizeof(ASTNodeTypeNames[0]))
+    if (node->type < sizeof(ASTNodeTypeNames)/sizeof(ASTNodeTypeNames[0]))
         printf("Type: %s\n", ASTNodeTypeNames[node->type]);
     else
         fatal_error("Type: UNKNOWN (%d)\n", node->type);
@@ -56,131 +206,101 @@ static inline void print_node(ASTNode* node, int depth) {
     switch (node->type) {
         case _GLOBAL_DECLARATION:
             print_indent(depth);
-            printf("Title: %s\n", node->list.title);
-            print_node(node->list.next, depth + 1);
+            printf("Title: %s\n", symbol_name(node->global.title));
+            if (node->global.size >= 0) {
+                print_indent(depth);
+                printf("Size: %d\n", node->global.size);
+            }
+            print_list(node->global.values, depth + 1);
             break;
-        case _AUTO:
-            print_node(node->list.next, depth + 1);
+        case _ASSIGNMENT:
+            print_indent(depth);
+            printf("Title: %s\n", symbol_name(node->assign.title));
+            print_later(node->assign.value, depth + 1);
             break;
-        case _EXTRN:
-            print_node(node->list.next, depth + 1);
+        case _ARRAY_ASSIGNMENT:
+            print_later(node->factors.right, depth + 1);
+            print_later(node->factors.left, depth + 1);
             break;
-        case _ASSIGNMENT:
+        case _ARRAY:
+            print_indent(depth);
+            printf("Title: %s\n", symbol_name(node->array.title));
             print_indent(depth);
-            printf("Title: %s\n", node->list.title);
-            print_node(node->list.next, depth + 1);
+            printf("Size: %d\n", node->array.size);
+            break;
+        case _AUTO:
+        case _EXTRN:
+            print_list(node->list.items, depth + 1);
             break;
         case _WHILE_LOOP:
-            print_node(node->list.inner, depth + 1);
-            print_node(node->list.next, depth + 1);
+            print_list(node->loop.statements, depth + 1);
+            print_later(node->loop.cond, depth + 1);
             break;
         case _IF:
-            print_node(node->if_t.cond, depth + 1);
-            print_node(node->if_t.statements, depth + 1);
-            print_node(node->if_t.else_t, depth + 1);
-            break;
-        case _LABEL:
-            print_indent(depth);
-            printf("Title: %s\n", node->string);
+            print_list(node->if_t.else_t, depth + 1);
+            print_list(node->if_t.statements, depth + 1);
+            print_later(node->if_t.cond, depth + 1);
             break;
         case _RETURN:
-            print_node(node->list.next, depth + 1);
+        case _NOT:
+        case _NEGATIVE:
+            print_later(node->inner, depth + 1);
             break;
         case _FUNCTION:
             print_indent(depth);
-            printf("Title: %s\n", node->function.title);
-            print_node(node->function.args, depth + 1);
-            print_node(node->function.statements, depth + 1);
+            printf("Title: %s\n", symbol_name(node->function.title));
+            print_list(node->function.statements, depth + 1);
+            print_list(node->function.args, depth + 1);
             break;
 
         case _ADD:
-            print_node(node->factors.left, depth + 1);
-            print_node(node->factors.right, depth + 1);
-            break;
         case _SUBTRACT:
-            print_node(node->factors.left, depth + 1);
-            print_node(node->factors.right, depth + 1);
-            break;
         case _MULTIPLY:
-            print_node(node->factors.left, depth + 1);
-            print_node(node->factors.right, depth + 1);
-            break;
         case _DIVIDE:
-            print_node(node->factors.left, depth + 1);
-            print_node(node->factors.right, depth + 1);
-            break;
         case _GTEQ:
-            print_node(node->factors.left, depth + 1);
-            print_node(node->factors.right, depth + 1);
-            break;
         case _LTEQ:
-            print_node(node->factors.left, depth + 1);
-            print_node(node->factors.right, depth + 1);
-            break;
         case _GREATER:
-            print_node(node->factors.left, depth + 1);
-            print_node(node->factors.right, depth + 1);
-            break;
         case _LESS:
-            print_node(node->factors.left, depth + 1);
-            print_node(node->factors.right, depth + 1);
-            break;
         case _EQUALS:
-            print_node(node->factors.left, depth + 1);
-            print_node(node->factors.right, depth + 1);
-            break;
         case _NEQUALS:
-            print_node(node->factors.left, depth + 1);
-            print_node(node->factors.right, depth + 1);
+            print_later(node->factors.right, depth + 1);
+            print_later(node->factors.left, depth + 1);
             break;
         case _FUNCTION_CALL:
+        case _ARRAY_REF:
             print_indent(depth);
-            printf("Title: %s\n", node->list.title);
-            print_node(node->list.next, depth + 1);
-            break;
-        
-        case _NOT:
-            print_node(node->inner, depth + 1);
+            printf("Title: %s\n", symbol_name(node->list.title));
+            print_list(node->list.items, depth + 1);
             break;
 
+        case _LABEL:
+        case _GOTO:
         case _INC:
-            print_indent(depth);
-            printf("Title: %s\n", node->string);
-            break;
         case _DEC:
+        case _VARIABLE:
             print_indent(depth);
-            printf("Title: %s\n", node->string);
+            printf("Title: %s\n", symbol_name(node->symbol));
             break;
 
         case _NUMBER:
             print_indent(depth);
             printf("Value: %d\n", node->integer);
             break;
-        case _VARIABLE:
-            print_indent(depth);
-            printf("Title: %s\n", node->string);
-            print_node(node->list.next, depth);
-            break;
-        case _ARRAY:
-            print_node(node->list.inner, depth + 1);
-            print_node(node->list.next, depth);
-            break;
-        case _ARRAY_REF:
-            print_indent(depth);
-            printf("Title: %s\n", node->list.title);
-            print_node(node->list.next, depth + 1);
-            break;
         default:
             print_indent(depth);
             printf("Unreachable code.\n");
             break;
     }
-
-    if (node->successor) print_node(node->successor, depth);
 }
 
-void print_ast() {
-    for (int i = 0; i < ast_length; i++) 
-        print_node(generated_ast[i], 0);
-    printf("\n");
+void print_ast(ASTIndex definition) {
+    print_later(definition, 0);
+    while (printing_length > 0) {
+        PrintItem item = printing[--printing_length];
+        print_node(item.index, item.depth);
+    }
+
+    free(printing);
+    printing = NULL;
+    printing_capacity = 0;
 }
\ No newline at end of file
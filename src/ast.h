@@ -22,6 +22,10 @@
 #ifndef AST_H
 #define AST_H
 
+#include <stddef.h>
+#include <stdint.h>
+#include "symtab.h"
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -30,79 +34,112 @@ typedef enum VariableType {
     VAR_AUTO, VAR_EXTRN
 } VariableType;
 
+typedef enum ASTNodeType {
+    _GLOBAL_DECLARATION,
+    _AUTO,
+    _EXTRN,
+    _ASSIGNMENT,
+    _ARRAY_ASSIGNMENT,
+    _WHILE_LOOP,
+    _IF,
+    _LABEL,
+    _RETURN,
+    _GOTO,
+    _FUNCTION,
+
+    
+    _ADD,
+    _SUBTRACT,
+    _MULTIPLY,
+    _DIVIDE,
+    _GTEQ,
+    _LTEQ,
+    _GREATER,
+    _LESS,
+    _EQUALS,
+    _NEQUALS,
+    _FUNCTION_CALL,
+
+    _NOT,
+    _NEGATIVE,
+
+    _INC,
+    _DEC,
+
+    _NUMBER,
+    _VARIABLE,
+    _ARRAY,
+    _ARRAY_REF,
+
+    STOP
+} ASTNodeType;
+
+/**
+ * Nodes refer to each other by 32-bit index into ast_nodes. Index 0 holds a
+ * STOP node and stands in for "no node".
+ */
+typedef uint32_t ASTIndex;
+
+/**
+ * Lists (statements, arguments, declarations, subscripts) are stored as a
+ * length-prefixed run inside ast_lists: ast_lists[list] is the length and
+ * the items follow it. List 0 is the empty list.
+ */
+typedef uint32_t ASTList;
+
 typedef struct ASTNode {
-    enum { 
-        _GLOBAL_DECLARATION,
-        _AUTO,
-        _EXTRN,
-        _ASSIGNMENT,
-        _WHILE_LOOP,
-        _IF,
-        _LABEL,
-        _RETURN,
-        _GOTO,
-        _FUNCTION,
-
-        
-        _ADD,
-        _SUBTRACT,
-        _MULTIPLY,
-        _DIVIDE,
-        _GTEQ,
-        _LTEQ,
-        _GREATER,
-        _LESS,
-        _EQUALS,
-        _NEQUALS,
-        _FUNCTION_CALL,
-
-        _NOT,
-        _NEGATIVE,
-
-        _INC,
-        _DEC,
-
-        _NUMBER,
-        _VARIABLE,
-        _ARRAY,
-        _ARRAY_REF,
-
-        STOP
-    } type;
+    uint8_t type;           // ASTNodeType
+    uint8_t variableType;   // VariableType of a declared _VARIABLE
     union {
         int integer;
 
-        char* string;
+        Symbol symbol;
 
-        struct ASTNode* inner;
+        ASTIndex inner;
 
         struct {
-            struct ASTNode* left;
-            struct ASTNode* right;
+            ASTIndex left;
+            ASTIndex right;
         } factors;
 
         struct {
-            union {
-                char* title;
-                struct ASTNode* inner;
-            };
-            struct ASTNode* next;
-            VariableType variableType;
+            Symbol title;
+            ASTIndex value;
+        } assign;
+
+        struct {
+            Symbol title;
+            ASTList items;
         } list;
 
         struct {
-            char* title;
-            struct ASTNode* args;
-            struct ASTNode* statements;
+            Symbol title;
+            int size;           // -1 for a scalar, else the [size] of a vector
+            ASTList values;
+        } global;
+
+        struct {
+            Symbol title;
+            int size;
+        } array;
+
+        struct {
+            Symbol title;
+            ASTList args;
+            ASTList statements;
         } function;
 
         struct {
-            struct ASTNode* cond;
-            struct ASTNode* statements;
-            struct ASTNode* else_t;
+            ASTIndex cond;
+            ASTList statements;
+        } loop;
+
+        struct {
+            ASTIndex cond;
+            ASTList statements;
+            ASTList else_t;
         } if_t;
     };
-    struct ASTNode* successor;
 } ASTNode;
 
 static const char* ASTNodeTypeNames[] = {
@@ -110,6 +147,7 @@ static const char* ASTNodeTypeNames[] = {
     "_AUTO",
     "_EXTRN",
     "_ASSIGNMENT",
+    "_ARRAY_ASSIGNMENT",
     "_WHILE_LOOP",
     "_IF",
     "_LABEL",
@@ -130,6 +168,7 @@ static const char* ASTNodeTypeNames[] = {
     "_FUNCTION_CALL",
 
     "_NOT",
+    "_NEGATIVE",
 
     "_INC",
     "_DEC",
@@ -142,12 +181,44 @@ static const char* ASTNodeTypeNames[] = {
     "STOP"
 };
 
-extern ASTNode** generated_ast;
-extern int ast_length;
-
-extern void append_statement(ASTNode* node);
-
-extern void print_ast();
+extern ASTNode* ast_nodes;
+extern uint32_t ast_node_count;
+
+extern uint32_t* ast_lists;
+extern uint32_t ast_list_words;
+
+static inline ASTNode* ast_node(ASTIndex index) { return &ast_nodes[index]; }
+static inline uint32_t ast_list_length(ASTList list) { return ast_lists[list]; }
+static inline const ASTIndex* ast_list_items(ASTList list) { return &ast_lists[list + 1]; }
+
+extern ASTIndex ast_new_node(ASTNodeType type);
+extern ASTIndex ast_new_binary(ASTNodeType type, ASTIndex left, ASTIndex right);
+
+/**
+ * Lists are collected on a scratch stack while the parser works through
+ * them and copied out in one piece once they are complete. Nested lists are
+ * always finished before their parent, so the stack discipline holds.
+ */
+extern uint32_t ast_list_begin();
+extern void ast_list_push(ASTIndex item);
+extern ASTList ast_list_end(uint32_t mark);
+// Ends a list rebuilt from `list`, keeping `list` itself if no item changed.
+extern ASTList ast_list_update(uint32_t mark, ASTList list);
+extern ASTList ast_list_of(ASTIndex item);
+
+/**
+ * The parser hands each function or external to compile_definition() as
+ * soon as it is complete. Once it is compiled, ast_recycle() drops every
+ * node and list but keeps their storage, so the tree never holds more than
+ * one definition. ast_release() frees it all, names included.
+ */
+extern void compile_definition(ASTIndex definition);
+extern void ast_recycle();
+extern void ast_release();
+
+extern void print_ast_stats();
+
+extern void print_ast(ASTIndex definition);
 
 #ifdef __cplusplus
 }
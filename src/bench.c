@@ -0,0 +1,641 @@
+/*
+   BLang
+   Copyright (c) 2025 William Gibbs
+
+   This software is provided 'as-is', without any express or implied
+   warranty. In no event will the authors be held liable for any damages
+   arising from the use of this software.
+
+   Permission is granted to anyone to use this software for any purpose,
+   including commercial applications, and to alter it and redistribute it
+   freely, subject to the following restrictions:
+
+   1. The origin of this software must not be misrepresented; you must not
+      claim that you wrote the original software. If you use this software
+      in a product, an acknowledgment in the product documentation would be
+      appreciated but is not required.
+   2. Altered source versions must be plainly marked as such, and must not be
+      misrepresented as being the original software.
+   3. This notice may not be removed or altered from any source distribution.
+*/
+
+
+/*
+ * blang-bench: generate large B programs and measure how fast blang
+ * compiles them.
+ *
+ *    blang-bench generate [<shape>...] [-o <output>]
+ *    blang-bench run [-compiler <blang>] [-baseline <json>] [-threshold <percent>]
+ *                    [-o <json>] <file>... [-- <blang flags>...]
+ *    blang-bench kernels [-compiler <blang>] [-cc <cc>] [-runs <n>] [-work <dir>]
+ *                        [-o <json>] <kernel.b>...
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "error.h"
+
+static void print_usage() {
+   printf(
+      "Usage: blang-bench generate [options] [-o <output>]\n"
+      "       blang-bench run [options] <file>... [-- <blang flags>...]\n"
+      "       blang-bench kernels [options] <kernel.b>...\n"
+      "\n"
+      "  generate   Write a deterministic B program of the given shape (default output: stdout)\n"
+      "     -functions <n>     functions in the program (default 100)\n"
+      "     -statements <n>    statements in each function (default 50)\n"
+      "     -depth <n>         depth of each expression tree (default 4)\n"
+      "     -nesting <n>       how deep if and while statements nest (default 2)\n"
+      "     -identifiers <n>   autos declared in each function (default 8)\n"
+      "     -seed <n>          seed of the generator (default 1)\n"
+      "\n"
+      "  run        Compile each file with -ftime-report and report the totals as JSON\n"
+      "     -compiler <path>   the blang to measure (default: blang)\n"
+      "     -baseline <json>   fail on a regression against this result, or record it there\n"
+      "     -threshold <pct>   slowdown or growth tolerated before failing (default 5)\n"
+      "     -o <json>          where to write the result (default: stdout)\n"
+      "\n"
+      "  kernels    Build each kernel and the C version next to it (kernel.c) at -O0 to -Oz,\n"
+      "             check they print the same and compare run time and executable size\n"
+      "     -compiler <path>   the blang to measure (default: blang)\n"
+      "     -cc <path>         the C compiler for the reference versions (default: cc)\n"
+      "     -runs <n>          best of this many runs is reported (default 3)\n"
+      "     -work <dir>        where executables are built (default: .)\n"
+      "     -o <json>          also write the table as JSON\n"
+   );
+   exit(EXIT_FAILURE);
+}
+
+static int parse_count(const char *option, const char *value, int minimum) {
+   if (!value) fatal_error("missing number after '%s'", option);
+   char *end;
+   long count = strtol(value, &end, 10);
+   if (*end != '\0' || count < minimum || count > 1000000)
+      fatal_error("invalid number '%s' after '%s'", value, option);
+   return (int)count;
+}
+
+/* ---- Generator ---------------------------------------------------------- */
+
+typedef struct Shape {
+   int functions;
+   int statements;
+   int depth;
+   int nesting;
+   int identifiers;
+   unsigned seed;
+} Shape;
+
+// xorshift64: the same seed gives the same program on every host.
+static uint64_t random_state;
+
+static unsigned random_below(unsigned bound) {
+   random_state ^= random_state << 13;
+   random_state ^= random_state >> 7;
+   random_state ^= random_state << 17;
+   return (unsigned)(random_state % bound);
+}
+
+static const char *operators[] = { "+", "-", "*", "/", "<", ">", "<=", ">=", "==", "!=" };
+
+static void generate_expression(FILE *out, const Shape *shape, int function, int depth) {
+   if (depth == 0 || random_below(4) == 0) {
+      unsigned leaf = random_below(8);
+      if (leaf == 0 && function > 0) {
+         int callee = (int)random_below((unsigned)function);
+         fprintf(out, "f%d(", callee);
+         generate_expression(out, shape, function, 0);
+         fprintf(out, ", ");
+         generate_expression(out, shape, function, 0);
+         fprintf(out, ")");
+      }
+      else if (leaf < 3) fprintf(out, "%u", random_below(1000));
+      else fprintf(out, "v%u", random_below((unsigned)shape->identifiers));
+      return;
+   }
+
+   fprintf(out, "(");
+   generate_expression(out, shape, function, depth - 1);
+   fprintf(out, " %s ", operators[random_below(sizeof(operators) / sizeof(operators[0]))]);
+   generate_expression(out, shape, function, depth - 1);
+   fprintf(out, ")");
+}
+
+static void generate_statements(FILE *out, const Shape *shape, int function, int level, int count, int *budget);
+
+static void generate_statement(FILE *out, const Shape *shape, int function, int level, int *budget) {
+   int indent = 3 * (level + 1);
+   unsigned kind = random_below(8);
+   (*budget)--;
+
+   if (kind == 0 && level < shape->nesting) {
+      unsigned counter = random_below((unsigned)shape->identifiers);
+      fprintf(out, "%*sv%u = 0;\n%*swhile (v%u < %u) {\n", indent, "", counter, indent, "", counter, 1 + random_below(100));
+      generate_statements(out, shape, function, level + 1, 1 + (int)random_below(4), budget);
+      fprintf(out, "%*sv%u++;\n%*s}\n", indent + 3, "", counter, indent, "");
+   }
+   else if (kind == 1 && level < shape->nesting) {
+      fprintf(out, "%*sif (", indent, "");
+      generate_expression(out, shape, function, shape->depth);
+      fprintf(out, ") {\n");
+      generate_statements(out, shape, function, level + 1, 1 + (int)random_below(4), budget);
+      fprintf(out, "%*s} else {\n", indent, "");
+      generate_statements(out, shape, function, level + 1, 1 + (int)random_below(4), budget);
+      fprintf(out, "%*s}\n", indent, "");
+   }
+   else {
+      fprintf(out, "%*sv%u = ", indent, "", random_below((unsigned)shape->identifiers));
+      generate_expression(out, shape, function, shape->depth);
+      fprintf(out, ";\n");
+   }
+}
+
+static void generate_statements(FILE *out, const Shape *shape, int function, int level, int count, int *budget) {
+   // Blocks always get at least one statement, even with the budget spent.
+   for (int i = 0; i < count && (i == 0 || *budget > 0); i++)
+      generate_statement(out, shape, function, level, budget);
+}
+
+static void generate_function(FILE *out, const Shape *shape, int function) {
+   fprintf(out, "f%d(a, b) {\n   auto v0", function);
+   for (int i = 1; i < shape->identifiers; i++) fprintf(out, ", v%d", i);
+   fprintf(out, ";\n");
+   for (int i = 0; i < shape->identifiers; i++) fprintf(out, "   v%d = %s;\n", i, i % 2 ? "b" : "a");
+
+   int budget = shape->statements;
+   while (budget > 0) generate_statement(out, shape, function, 0, &budget);
+
+   fprintf(out, "   return (");
+   generate_expression(out, shape, function, shape->depth);
+   fprintf(out, ");\n}\n\n");
+}
+
+static int generate(int argc, char *argv[]) {
+   Shape shape = { 100, 50, 4, 2, 8, 1 };
+   const char *output = NULL;
+
+   for (int i = 0; i < argc; i++) {
+      const char *value = i + 1 < argc ? argv[i + 1] : NULL;
+      if (strcmp(argv[i], "-o") == 0) {
+         if (!value) fatal_error("missing file name after '-o'");
+         output = value;
+      }
+      else if (strcmp(argv[i], "-functions") == 0) shape.functions = parse_count(argv[i], value, 1);
+      else if (strcmp(argv[i], "-statements") == 0) shape.statements = parse_count(argv[i], value, 1);
+      else if (strcmp(argv[i], "-depth") == 0) shape.depth = parse_count(argv[i], value, 0);
+      else if (strcmp(argv[i], "-nesting") == 0) shape.nesting = parse_count(argv[i], value, 0);
+      else if (strcmp(argv[i], "-identifiers") == 0) shape.identifiers = parse_count(argv[i], value, 2);
+      else if (strcmp(argv[i], "-seed") == 0) shape.seed = (unsigned)parse_count(argv[i], value, 0);
+      else print_usage();
+      i++;
+   }
+
+   FILE *out = output ? fopen(output, "w") : stdout;
+   if (!out) fatal_error("could not open \"%s\" for writing", output);
+
+   // A zero state would stay zero, so the seed is mixed into a fixed constant.
+   random_state = 0x9E3779B97F4A7C15ull ^ shape.seed;
+
+   fprintf(out, "/* blang-bench: -functions %d -statements %d -depth %d -nesting %d -identifiers %d -seed %u */\n\n",
+      shape.functions, shape.statements, shape.depth, shape.nesting, shape.identifiers, shape.seed);
+   for (int i = 0; i < shape.functions; i++) generate_function(out, &shape, i);
+   fprintf(out, "main() {\n   return (f%d(1, 2));\n}\n", shape.functions - 1);
+
+   if (out != stdout && fclose(out) != 0) fatal_error("could not write \"%s\"", output);
+   return EXIT_SUCCESS;
+}
+
+/* ---- Harness ------------------------------------------------------------ */
+
+#define MAX_PHASES 32
+
+// Top-level rows of blang's -ftime-report, summed over the corpus.
+typedef struct PhaseTotal {
+   char name[64];
+   double seconds;
+} PhaseTotal;
+
+typedef struct Result {
+   int files;
+   long lines;
+   double seconds;
+   long peakRSS;            // kilobytes
+   int phaseCount;
+   PhaseTotal phases[MAX_PHASES];
+} Result;
+
+static char *read_file(const char *path, size_t *length) {
+   FILE *file = fopen(path, "rb");
+   if (!file) return NULL;
+
+   size_t capacity = 4096, used = 0;
+   char *text = malloc(capacity);
+   size_t got;
+   while (text && (got = fread(text + used, 1, capacity - used - 1, file)) > 0) {
+      used += got;
+      if (capacity - used == 1) text = realloc(text, capacity *= 2);
+   }
+   fclose(file);
+   if (!text) fatal_error("out of memory");
+
+   text[used] = '\0';
+   if (length) *length = used;
+   return text;
+}
+
+static void add_phase(Result *result, const char *name, double seconds) {
+   for (int i = 0; i < result->phaseCount; i++) {
+      if (strcmp(result->phases[i].name, name) == 0) {
+         result->phases[i].seconds += seconds;
+         return;
+      }
+   }
+   if (result->phaseCount == MAX_PHASES) return;
+
+   PhaseTotal *phase = &result->phases[result->phaseCount++];
+   snprintf(phase->name, sizeof(phase->name), "%s", name);
+   phase->seconds = seconds;
+}
+
+// Rows look like "  <seconds>   <percent>%  <count>   <indent><phase>".
+static void parse_report(Result *result, char *report) {
+   for (char *line = strtok(report, "\n"); line; line = strtok(NULL, "\n")) {
+      double seconds, percent;
+      unsigned count;
+      int consumed;
+      if (sscanf(line, "%lf %lf%% %u%n", &seconds, &percent, &count, &consumed) != 3) continue;
+
+      const char *name = line + consumed;
+      if (strncmp(name, "   ", 3) != 0 || name[3] == ' ') continue;  // nested phases are part of their parent
+      add_phase(result, name + 3, seconds);
+   }
+}
+
+static double now() {
+   struct timespec time;
+   clock_gettime(CLOCK_MONOTONIC, &time);
+   return time.tv_sec + time.tv_nsec / 1e9;
+}
+
+typedef struct Process {
+   char *output;            // what it wrote to the captured descriptor
+   double seconds;          // wall time
+   long peakRSS;            // kilobytes
+   bool succeeded;          // exited with status 0
+} Process;
+
+// Runs args[0] to completion, collecting what it writes to `fd`.
+static Process run_process(const char **args, int fd) {
+   Process process = { 0 };
+   int pipeline[2];
+   if (pipe(pipeline) != 0) fatal_error("could not create a pipe");
+
+   double start = now();
+   pid_t pid = fork();
+   if (pid < 0) fatal_error("could not fork");
+   if (pid == 0) {
+      dup2(pipeline[1], fd);
+      close(pipeline[0]);
+      close(pipeline[1]);
+      execvp(args[0], (char *const *)args);
+      fprintf(stderr, "could not run \"%s\"\n", args[0]);
+      _exit(127);
+   }
+   close(pipeline[1]);
+
+   size_t capacity = 4096, used = 0;
+   char *text = malloc(capacity);
+   ssize_t got;
+   while (text && (got = read(pipeline[0], text + used, capacity - used - 1)) > 0) {
+      used += (size_t)got;
+      if (capacity - used == 1) text = realloc(text, capacity *= 2);
+   }
+   close(pipeline[0]);
+   if (!text) fatal_error("out of memory");
+   text[used] = '\0';
+
+   int status;
+   struct rusage usage;
+   if (wait4(pid, &status, 0, &usage) != pid) fatal_error("lost track of \"%s\"", args[0]);
+   process.seconds = now() - start;
+   process.succeeded = WIFEXITED(status) && WEXITSTATUS(status) == 0;
+   process.output = text;
+
+#if defined(__APPLE__)
+   process.peakRSS = usage.ru_maxrss / 1024;    // bytes on Darwin
+#else
+   process.peakRSS = usage.ru_maxrss;
+#endif
+   return process;
+}
+
+static void run_compiler(Result *result, const char *compiler, const char *input, char **flags, int flagCount) {
+   char output[4096];
+   snprintf(output, sizeof(output), "%s.o", input);
+
+   const char **args = calloc(flagCount + 8, sizeof(char *));
+   int n = 0;
+   args[n++] = compiler;
+   args[n++] = "-ftime-report";
+   args[n++] = "-c";
+   args[n++] = "-o";
+   args[n++] = output;
+   for (int i = 0; i < flagCount; i++) args[n++] = flags[i];
+   args[n++] = input;
+   args[n] = NULL;
+
+   Process process = run_process(args, STDERR_FILENO);
+   if (!process.succeeded) {
+      fputs(process.output, stderr);
+      fatal_error("\"%s\" failed on \"%s\"", compiler, input);
+   }
+
+   result->seconds += process.seconds;
+   if (process.peakRSS > result->peakRSS) result->peakRSS = process.peakRSS;
+   parse_report(result, process.output);
+
+   free(process.output);
+   free(args);
+   unlink(output);
+}
+
+static void write_result(FILE *out, const Result *result) {
+   fprintf(out, "{\n");
+   fprintf(out, "  \"files\": %d,\n", result->files);
+   fprintf(out, "  \"lines\": %ld,\n", result->lines);
+   fprintf(out, "  \"seconds\": %.6f,\n", result->seconds);
+   fprintf(out, "  \"lines_per_second\": %.1f,\n", result->seconds > 0 ? result->lines / result->seconds : 0.0);
+   fprintf(out, "  \"peak_rss_kb\": %ld,\n", result->peakRSS);
+   fprintf(out, "  \"phases\": {");
+   for (int i = 0; i < result->phaseCount; i++)
+      fprintf(out, "%s\n    \"%s\": %.6f", i ? "," : "", result->phases[i].name, result->phases[i].seconds);
+   fprintf(out, "\n  }\n}\n");
+}
+
+// Only reads back what write_result() wrote: every key is unique in the file.
+static bool json_number(const char *json, const char *key, double *value) {
+   char quoted[80];
+   snprintf(quoted, sizeof(quoted), "\"%s\":", key);
+   const char *found = strstr(json, quoted);
+   return found && sscanf(found + strlen(quoted), "%lf", value) == 1;
+}
+
+// Phases shorter than this are too noisy to hold against the baseline.
+#define PHASE_NOISE_FLOOR 0.05
+
+static bool compare(const Result *result, const char *baseline, double threshold) {
+   bool regressed = false;
+   double slack = threshold / 100.0;
+   double base;
+
+   double rate = result->seconds > 0 ? result->lines / result->seconds : 0.0;
+   if (json_number(baseline, "lines_per_second", &base) && rate < base * (1.0 - slack)) {
+      fprintf(stderr, "blang-bench: regression: %.1f lines/s, baseline %.1f (%+.1f%%)\n",
+         rate, base, (rate / base - 1.0) * 100.0);
+      regressed = true;
+   }
+
+   if (json_number(baseline, "peak_rss_kb", &base) && result->peakRSS > base * (1.0 + slack)) {
+      fprintf(stderr, "blang-bench: regression: peak RSS %ld KB, baseline %.0f KB (%+.1f%%)\n",
+         result->peakRSS, base, (result->peakRSS / base - 1.0) * 100.0);
+      regressed = true;
+   }
+
+   for (int i = 0; i < result->phaseCount; i++) {
+      const PhaseTotal *phase = &result->phases[i];
+      if (!json_number(baseline, phase->name, &base) || base < PHASE_NOISE_FLOOR) continue;
+      if (phase->seconds > base * (1.0 + slack)) {
+         fprintf(stderr, "blang-bench: regression: %s took %.4fs, baseline %.4fs (%+.1f%%)\n",
+            phase->name, phase->seconds, base, (phase->seconds / base - 1.0) * 100.0);
+         regressed = true;
+      }
+   }
+
+   return regressed;
+}
+
+static int run(int argc, char *argv[]) {
+   const char *compiler = "blang";
+   const char *baseline = NULL;
+   const char *output = NULL;
+   double threshold = 5.0;
+   char **flags = NULL;
+   int flagCount = 0;
+   Result result = { 0 };
+
+   char **inputs = calloc(argc + 1, sizeof(char *));
+   int inputCount = 0;
+
+   for (int i = 0; i < argc; i++) {
+      const char *value = i + 1 < argc ? argv[i + 1] : NULL;
+      if (strcmp(argv[i], "--") == 0) {
+         flags = argv + i + 1;
+         flagCount = argc - i - 1;
+         break;
+      }
+      else if (strcmp(argv[i], "-compiler") == 0 || strcmp(argv[i], "-baseline") == 0 ||
+               strcmp(argv[i], "-threshold") == 0 || strcmp(argv[i], "-o") == 0) {
+         if (!value) fatal_error("missing argument after '%s'", argv[i]);
+         if (argv[i][1] == 'c') compiler = value;
+         else if (argv[i][1] == 'b') baseline = value;
+         else if (argv[i][1] == 'o') output = value;
+         else if ((threshold = atof(value)) <= 0) fatal_error("invalid threshold '%s'", value);
+         i++;
+      }
+      else inputs[inputCount++] = argv[i];
+   }
+   if (inputCount == 0) print_usage();
+
+   for (int i = 0; i < inputCount; i++) {
+      size_t length;
+      char *text = read_file(inputs[i], &length);
+      if (!text) fatal_error("could not read \"%s\"", inputs[i]);
+      for (size_t c = 0; c < length; c++) result.lines += text[c] == '\n';
+      free(text);
+
+      run_compiler(&result, compiler, inputs[i], flags, flagCount);
+      result.files++;
+   }
+   free(inputs);
+
+   FILE *out = output ? fopen(output, "w") : stdout;
+   if (!out) fatal_error("could not open \"%s\" for writing", output);
+   write_result(out, &result);
+   if (out != stdout && fclose(out) != 0) fatal_error("could not write \"%s\"", output);
+
+   if (!baseline) return EXIT_SUCCESS;
+
+   char *stored = read_file(baseline, NULL);
+   if (!stored) {
+      // The first run on a machine becomes the baseline later runs answer to.
+      FILE *file = fopen(baseline, "w");
+      if (!file) fatal_error("could not open \"%s\" for writing", baseline);
+      write_result(file, &result);
+      fclose(file);
+      fprintf(stderr, "blang-bench: recorded baseline \"%s\"\n", baseline);
+      return EXIT_SUCCESS;
+   }
+
+   bool regressed = compare(&result, stored, threshold);
+   free(stored);
+   return regressed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
+
+/* ---- Kernels ------------------------------------------------------------ */
+
+static const char *levels[] = { "-O0", "-O1", "-O2", "-O3", "-Os", "-Oz" };
+#define LEVEL_COUNT (int)(sizeof(levels) / sizeof(levels[0]))
+
+// One kernel at one level, built from B and from C.
+typedef struct KernelRow {
+   char name[64];
+   const char *level;
+   double seconds[2];       // best run of the B and the C executable
+   long size[2];            // their sizes in bytes
+} KernelRow;
+
+static void build(const char *compiler, const char *level, const char *source, const char *executable) {
+   const char *args[] = { compiler, level, "-o", executable, source, NULL };
+   Process process = run_process(args, STDERR_FILENO);
+   if (!process.succeeded) {
+      fputs(process.output, stderr);
+      fatal_error("\"%s\" %s failed on \"%s\"", compiler, level, source);
+   }
+   free(process.output);
+}
+
+// Best of `runs` runs; the output of the first is handed back for comparison.
+static double time_executable(const char *executable, int runs, char **output) {
+   const char *args[] = { executable, NULL };
+   double best = 0;
+   for (int i = 0; i < runs; i++) {
+      Process process = run_process(args, STDOUT_FILENO);
+      if (!process.succeeded) fatal_error("\"%s\" failed", executable);
+      if (i == 0 || process.seconds < best) best = process.seconds;
+      if (i == 0) *output = process.output;
+      else free(process.output);
+   }
+   return best;
+}
+
+static long file_size(const char *path) {
+   struct stat info;
+   if (stat(path, &info) != 0) fatal_error("could not stat \"%s\"", path);
+   return (long)info.st_size;
+}
+
+static void write_kernels(FILE *out, const KernelRow *rows, int count) {
+   fprintf(out, "[");
+   for (int i = 0; i < count; i++) {
+      const KernelRow *row = &rows[i];
+      fprintf(out, "%s\n  { \"kernel\": \"%s\", \"level\": \"%s\", "
+         "\"b_seconds\": %.6f, \"c_seconds\": %.6f, \"ratio\": %.3f, "
+         "\"b_size\": %ld, \"c_size\": %ld }",
+         i ? "," : "", row->name, row->level, row->seconds[0], row->seconds[1],
+         row->seconds[1] > 0 ? row->seconds[0] / row->seconds[1] : 0.0, row->size[0], row->size[1]);
+   }
+   fprintf(out, "\n]\n");
+}
+
+static int kernels(int argc, char *argv[]) {
+   const char *compiler = "blang";
+   const char *cc = "cc";
+   const char *work = ".";
+   const char *output = NULL;
+   int runs = 3;
+
+   KernelRow *rows = calloc((size_t)(argc + 1) * LEVEL_COUNT, sizeof(KernelRow));
+   int rowCount = 0;
+   bool mismatched = false;
+
+   printf("%-12s %-5s %12s %12s %8s %10s %10s\n", "kernel", "level", "B (s)", "C (s)", "B/C", "B bytes", "C bytes");
+
+   for (int i = 0; i < argc; i++) {
+      const char *value = i + 1 < argc ? argv[i + 1] : NULL;
+      if (strcmp(argv[i], "-compiler") == 0 || strcmp(argv[i], "-cc") == 0 || strcmp(argv[i], "-work") == 0 ||
+          strcmp(argv[i], "-o") == 0 || strcmp(argv[i], "-runs") == 0) {
+         if (!value) fatal_error("missing argument after '%s'", argv[i]);
+         if (strcmp(argv[i], "-compiler") == 0) compiler = value;
+         else if (strcmp(argv[i], "-cc") == 0) cc = value;
+         else if (strcmp(argv[i], "-work") == 0) work = value;
+         else if (strcmp(argv[i], "-o") == 0) output = value;
+         else runs = parse_count(argv[i], value, 1);
+         i++;
+         continue;
+      }
+
+      // kernel.b is measured against kernel.c beside it.
+      const char *source = argv[i];
+      size_t length = strlen(source);
+      if (length < 3 || strcmp(source + length - 2, ".b") != 0) fatal_error("\"%s\" is not a .b file", source);
+      char reference[4096];
+      snprintf(reference, sizeof(reference), "%.*s.c", (int)(length - 2), source);
+
+      const char *base = strrchr(source, '/');
+      base = base ? base + 1 : source;
+
+      for (int l = 0; l < LEVEL_COUNT; l++) {
+         KernelRow *row = &rows[rowCount++];
+         snprintf(row->name, sizeof(row->name), "%.*s", (int)strlen(base) - 2, base);
+         row->level = levels[l];
+
+         char executable[2][4096];
+         char *printed[2];
+         snprintf(executable[0], sizeof(executable[0]), "%s/%s%s-b", work, row->name, levels[l]);
+         snprintf(executable[1], sizeof(executable[1]), "%s/%s%s-c", work, row->name, levels[l]);
+         build(compiler, levels[l], source, executable[0]);
+         build(cc, levels[l], reference, executable[1]);
+
+         for (int k = 0; k < 2; k++) {
+            row->seconds[k] = time_executable(executable[k], runs, &printed[k]);
+            row->size[k] = file_size(executable[k]);
+         }
+
+         printf("%-12s %-5s %12.4f %12.4f %7.2fx %10ld %10ld\n", row->name, row->level,
+            row->seconds[0], row->seconds[1], row->seconds[1] > 0 ? row->seconds[0] / row->seconds[1] : 0.0,
+            row->size[0], row->size[1]);
+         fflush(stdout);
+
+         if (strcmp(printed[0], printed[1]) != 0) {
+            fprintf(stderr, "blang-bench: %s at %s printed \"%s\", the C version \"%s\"\n",
+               row->name, row->level, printed[0], printed[1]);
+            mismatched = true;
+         }
+         free(printed[0]);
+         free(printed[1]);
+      }
+   }
+   if (rowCount == 0) print_usage();
+
+   if (output) {
+      FILE *out = fopen(output, "w");
+      if (!out) fatal_error("could not open \"%s\" for writing", output);
+      write_kernels(out, rows, rowCount);
+      if (fclose(out) != 0) fatal_error("could not write \"%s\"", output);
+   }
+
+   free(rows);
+   return mismatched ? EXIT_FAILURE : EXIT_SUCCESS;
+}
+
+int main(int argc, char *argv[]) {
+   if (argc < 2) print_usage();
+
+   if (strcmp(argv[1], "generate") == 0) return generate(argc - 2, argv + 2);
+   if (strcmp(argv[1], "run") == 0) return run(argc - 2, argv + 2);
+   if (strcmp(argv[1], "kernels") == 0) return kernels(argc - 2, argv + 2);
+
+   print_usage();
+   return EXIT_FAILURE;
+}
\ No newline at end of file
@@ -19,9 +19,15 @@
    3. This notice may not be removed or altered from any source distribution.
 */
 
+#include <algorithm>
+#include <chrono>
+#include <cstring>
 #include <iostream>
+#include <optional>
+#include <vector>
 
 #include "llvm.h"
+#include "link.h"
 #include "context.h"
 #include "error.h"
 #include "opt.h"
@@ -37,17 +43,30 @@
 #include <llvm/Support/raw_ostream.h>
 #include <llvm/Support/FileSystem.h>
 #include <llvm/IR/LegacyPassManager.h>
+#include <llvm/Bitcode/BitcodeReader.h>
+#include <llvm/Bitcode/BitcodeWriter.h>
+#include <llvm/Linker/Linker.h>
+#include <llvm/Support/MemoryBuffer.h>
+#include <llvm/Support/ThreadPool.h>
+#include <llvm/Support/Threading.h>
+#include <llvm/Support/TimeProfiler.h>
+#include <llvm/Transforms/IPO/Internalize.h>
+#include <llvm/Transforms/Utils/SplitModule.h>
 
 #include "llvm/Passes/PassBuilder.h"
 #include "llvm/Passes/StandardInstrumentations.h"
 #include "llvm/Analysis/AliasAnalysis.h"
+#include "llvm/Analysis/ModuleSummaryAnalysis.h"
 #include "llvm/Transforms/Scalar.h"
 #include "llvm/Transforms/Utils.h"
 
 #include <llvm/TargetParser/Host.h>
+#include <llvm/TargetParser/SubtargetFeature.h>
 
 extern "C" void initialize_llvm() {
    TheContext = std::make_unique<llvm::LLVMContext>();
+   // Names like addtmp only help someone reading the IR, and cost an allocation each.
+   TheContext->setDiscardValueNames(!ctx.emitLLVM);
    Builder = std::unique_ptr<llvm::IRBuilder<>>(new llvm::IRBuilder<>(*TheContext));
    TheModule = std::make_unique<llvm::Module>(ctx.inputFile, *TheContext);
 
@@ -65,57 +84,131 @@ extern "C" void initialize_llvm() {
    LLVMInitializeAArch64AsmPrinter();
 }
 
-extern "C" void export_asm() {
+static const llvm::CodeGenFileType AssemblyFileType = llvm::CodeGenFileType::AssemblyFile;
+static const llvm::CodeGenFileType ObjectFileType = llvm::CodeGenFileType::ObjectFile;
+
+/**
+ * Code generation effort follows -O. At -O0 LLVM also switches to the fast
+ * register allocator, so together with FastISel a debug build spends as
+ * little time in the backend as it can.
+ */
+static llvm::CodeGenOptLevel codegen_level() {
+   switch (ctx.optimization) {
+      case 0:  return llvm::CodeGenOptLevel::None;
+      case 1:  return llvm::CodeGenOptLevel::Less;
+      case 3:  return llvm::CodeGenOptLevel::Aggressive;
+      default: return llvm::CodeGenOptLevel::Default;     // -O2, -Os, -Oz
+   }
+}
+
+/**
+ * -mcpu=<name> picks the CPU, and -march=native (or -mcpu=native) the host's.
+ * Without either, code runs on any CPU of the target architecture.
+ */
+static std::string target_cpu() {
+   if (!ctx.targetCPU) return "generic";
+   if (strcmp(ctx.targetCPU, "native") == 0) return llvm::sys::getHostCPUName().str();
+   return ctx.targetCPU;
+}
+
+/**
+ * Host features detected for "native", with -mattr=+a,-b,... applied on top.
+ */
+static std::string target_features() {
+   llvm::SubtargetFeatures features;
+
+   if (ctx.targetCPU && strcmp(ctx.targetCPU, "native") == 0)
+      for (const auto& feature : llvm::sys::getHostCPUFeatures())
+         features.AddFeature(feature.first(), feature.second);
+
+   if (ctx.targetFeatures) {
+      llvm::SmallVector<llvm::StringRef, 8> requested;
+      llvm::StringRef(ctx.targetFeatures).split(requested, ',', -1, false);
+      for (llvm::StringRef feature : requested)
+         features.AddFeature(feature);
+   }
+
+   return features.getString();
+}
+
+/**
+ * The one place a TargetMachine is made. A TargetMachine must not be shared
+ * between threads, so parallel code generation asks for one per partition.
+ */
+static std::unique_ptr<llvm::TargetMachine> create_target_machine() {
    // Construct a Triple from the default target triple string
    llvm::Triple triple(llvm::sys::getDefaultTargetTriple());
 
-   // Set the module's target triple (takes llvm::Triple now)
-   TheModule->setTargetTriple(triple);
-
    // Look up the target with the Triple
    std::string error;
    auto target = llvm::TargetRegistry::lookupTarget(triple, error);
-   if (!target) {
-      llvm::errs() << "Failed to lookup target: " << error << "\n";
-      return;
-   }
+   if (!target)
+      fatal_error("failed to lookup target: %s", error.c_str());
 
    // Create the TargetMachine using the Triple (string overload is deprecated)
    llvm::TargetOptions opt;
-   auto RM = std::optional<llvm::Reloc::Model>();
-   auto targetMachine = target->createTargetMachine(triple, "generic", "", opt, RM);
+   opt.FunctionSections = ctx.functionSections;
+   opt.DataSections = ctx.dataSections;
+
+   // -fglobal-isel falls back to SelectionDAG for anything GlobalISel cannot
+   // select on the target yet, instead of aborting.
+   if (ctx.globalISel) {
+      opt.EnableGlobalISel = true;
+      opt.GlobalISelAbort = llvm::GlobalISelAbortMode::Disable;
+   } else if (ctx.optimization == 0) {
+      opt.EnableFastISel = true;
+   }
+
+   auto RM = std::optional<llvm::Reloc::Model>(ctx.pic ? llvm::Reloc::PIC_ : llvm::Reloc::Static);
+   return std::unique_ptr<llvm::TargetMachine>(target->createTargetMachine(
+      triple, target_cpu(), target_features(), opt, RM, std::nullopt, codegen_level()));
+}
+
+static void prepare_module(llvm::Module& module, llvm::TargetMachine& targetMachine) {
+   // Set the module's target triple and update the data layout to match
+   module.setTargetTriple(targetMachine.getTargetTriple());
+   module.setDataLayout(targetMachine.createDataLayout());
 
-   // Update the module data layout
-   TheModule->setDataLayout(targetMachine->createDataLayout());
+   // Code for a PIE may assume its own symbols are never preempted.
+   if (ctx.pic) {
+      module.setPICLevel(llvm::PICLevel::BigPIC);
+      module.setPIELevel(llvm::PIELevel::Large);
+   }
 
+   // The optimizer's cost models read the CPU and features off each function.
+   llvm::StringRef cpu = targetMachine.getTargetCPU();
+   llvm::StringRef features = targetMachine.getTargetFeatureString();
+   for (llvm::Function& function : module) {
+      if (function.isDeclaration()) continue;
+      function.addFnAttr("target-cpu", cpu);
+      if (!features.empty()) function.addFnAttr("target-features", features);
+   }
+}
+
+static void emit_file(llvm::Module& module, llvm::TargetMachine& targetMachine, const char* path, llvm::CodeGenFileType fileType) {
    // Prepare output file
    std::error_code EC;
-   llvm::raw_fd_ostream dest(ctx.outputFilename, EC, llvm::sys::fs::OF_None);
+   llvm::raw_fd_ostream dest(path, EC, llvm::sys::fs::OF_None);
 
-   if (EC) {
-      llvm::errs() << "Could not open file: " << EC.message() << "\n";
-      return;
-   }
+   if (EC)
+      fatal_error("Could not open file: %s", EC.message().c_str());
 
    // Create a pass manager to emit machine code
    llvm::legacy::PassManager pass;
 
-   // Set file type: object file (.o)
-#if defined(__APPLE__)
-    llvm::CodeGenFileType fileType = llvm::CodeGenFileType::AssemblyFile;
-#else
-    llvm::CodeGenFileType fileType = llvm::CGFT_AssemblyFile;
-#endif
-
-   if (targetMachine->addPassesToEmitFile(pass, dest, nullptr, fileType)) {
-      llvm::errs() << "TargetMachine can't emit a file of this type\n";
-      return;
-   }
+   if (targetMachine.addPassesToEmitFile(pass, dest, nullptr, fileType, !ctx.verify))
+      fatal_error("TargetMachine can't emit a file of this type");
 
-   pass.run(*TheModule);
+   pass.run(module);
    dest.flush();
 }
 
+extern "C" void export_asm() {
+   auto targetMachine = create_target_machine();
+   prepare_module(*TheModule, *targetMachine);
+   emit_file(*TheModule, *targetMachine, ctx.outputFilename, AssemblyFileType);
+}
+
 extern "C" void export_ir() {
    std::error_code EC;
    llvm::raw_fd_ostream dest("output.ll", EC, llvm::sys::fs::OF_None);
@@ -126,68 +219,171 @@ extern "C" void export_ir() {
       TheModule->print(dest, nullptr); // Print IR to file
 }
 
-extern "C" void export_bin() {
-   // Construct a Triple from the default target triple string
-   llvm::Triple triple(llvm::sys::getDefaultTargetTriple());
+/**
+ * Without -c the object is linked into an executable, where the linker and
+ * the runtime support it: ELF targets. Elsewhere the object is the output.
+ */
+static bool links_executable(llvm::TargetMachine& targetMachine) {
+   if (ctx.compileOnly) return false;
+   if (targetMachine.getTargetTriple().isOSBinFormatELF()) return true;
+
+   if (ctx.verbose)
+      fprintf(stderr, "blang: no linker support for %s, writing an object file\n",
+         targetMachine.getTargetTriple().str().c_str());
+   return false;
+}
 
-   // Set the module's target triple (takes llvm::Triple now)
-   TheModule->setTargetTriple(triple);
+static void export_bin_parallel();
 
-   // Look up the target with the Triple
-   std::string error;
-   auto target = llvm::TargetRegistry::lookupTarget(triple, error);
-   if (!target) {
-      llvm::errs() << "Failed to lookup target: " << error << "\n";
+/**
+ * -flto: the "object" is bitcode, and code generation happens when the
+ * linker has seen every unit.
+ */
+static void export_bin_lto() {
+   if (ctx.compileOnly) {
+      export_bc(ctx.outputFilename);
       return;
    }
 
-   // Create the TargetMachine using the Triple (string overload is deprecated)
-   llvm::TargetOptions opt;
-   auto RM = std::optional<llvm::Reloc::Model>();
-   auto targetMachine = target->createTargetMachine(triple, "generic", "", opt, RM);
+   char* object = temporary_file("o");
+   export_bc(object);
+   const char* objects[] = { object };
+   link_executable(objects, 1, ctx.outputFilename);
+   llvm::sys::fs::remove(object);
+   free(object);
+}
 
-   // Update the module data layout
-   TheModule->setDataLayout(targetMachine->createDataLayout());
+extern "C" void export_bin() {
+   if (ctx.lto) {
+      export_bin_lto();
+      return;
+   }
 
-   // Prepare output file
-   std::error_code EC;
-   llvm::raw_fd_ostream dest(ctx.outputFilename, EC, llvm::sys::fs::OF_None);
+   if (ctx.parallelCodegen) {
+      export_bin_parallel();
+      return;
+   }
 
-   if (EC) {
-      llvm::errs() << "Could not open file: " << EC.message() << "\n";
+   auto targetMachine = create_target_machine();
+   prepare_module(*TheModule, *targetMachine);
+
+   if (!links_executable(*targetMachine)) {
+      emit_file(*TheModule, *targetMachine, ctx.outputFilename, ObjectFileType);
       return;
    }
 
-   // Create a pass manager to emit machine code
-   llvm::legacy::PassManager pass;
+   char* object = temporary_file("o");
+   emit_file(*TheModule, *targetMachine, object, ObjectFileType);
+   const char* objects[] = { object };
+   link_executable(objects, 1, ctx.outputFilename);
+   llvm::sys::fs::remove(object);
+   free(object);
+}
 
-   // Set file type: object file (.o)
-#if defined(__APPLE__)
-   llvm::CodeGenFileType fileType = llvm::CodeGenFileType::ObjectFile;
-#else
-   llvm::CodeGenFileType fileType = llvm::CGFT_ObjectFile;
-#endif
+/**
+ * Bitcode carries the target triple and per-function CPU, so link-time
+ * optimization generates code for the same target. -flto=thin adds the
+ * module summary the ThinLTO backends plan their imports from.
+ */
+extern "C" void export_bc(const char* path) {
+   std::error_code EC;
+   llvm::raw_fd_ostream dest(path, EC, llvm::sys::fs::OF_None);
 
-   if (targetMachine->addPassesToEmitFile(pass, dest, nullptr, fileType)) {
-      llvm::errs() << "TargetMachine can't emit a file of this type\n";
-      return;
+   if (EC)
+      fatal_error("Could not open file: %s", EC.message().c_str());
+
+   auto targetMachine = create_target_machine();
+   prepare_module(*TheModule, *targetMachine);
+
+   if (ctx.lto == 2) {
+      llvm::ModuleSummaryIndex summary = llvm::buildModuleSummaryIndex(*TheModule, nullptr, nullptr);
+      llvm::WriteBitcodeToFile(*TheModule, dest, false, &summary);
+   } else {
+      llvm::WriteBitcodeToFile(*TheModule, dest);
    }
+}
 
-   pass.run(*TheModule);
-   dest.flush();
+// Link a unit compiled by export_bc() into TheModule.
+extern "C" void link_bc(const char* path) {
+   auto buffer = llvm::MemoryBuffer::getFile(path);
+   if (!buffer)
+      fatal_error("could not read \"%s\": %s", path, buffer.getError().message().c_str());
+
+   auto unit = llvm::parseBitcodeFile((*buffer)->getMemBufferRef(), *TheContext);
+   if (!unit)
+      fatal_error("could not load \"%s\": %s", path, llvm::toString(unit.takeError()).c_str());
+
+   if (llvm::Linker::linkModules(*TheModule, std::move(*unit)))
+      fatal_error("failed to link \"%s\"", path);
 }
 
-extern "C" void optimize() {
-   if (GCC_LIKELY(!ctx.optimization)) return;
+/**
+ * Link the runtime's single-character I/O (runtime/char.c, installed as
+ * blang-rt.bc) into TheModule, so that optimization inlines putchar and
+ * getchar into their callers instead of calling into the archive once per
+ * byte. Only what the program calls is linked, and internalized: the
+ * archive keeps providing the buffers and slow paths, and any other unit.
+ */
+static void link_runtime_bitcode() {
+   char* path = find_runtime("blang-rt.bc");
+   if (!path) return;
+
+   auto buffer = llvm::MemoryBuffer::getFile(path);
+   if (!buffer)
+      fatal_error("could not read \"%s\": %s", path, buffer.getError().message().c_str());
+
+   auto runtime = llvm::parseBitcodeFile((*buffer)->getMemBufferRef(), *TheContext);
+   if (!runtime)
+      fatal_error("could not load \"%s\": %s", path, llvm::toString(runtime.takeError()).c_str());
+   free(path);
+
+   // Inlining needs matching targets: take the ones prepare_module() gave TheModule.
+   (*runtime)->setTargetTriple(TheModule->getTargetTriple());
+   (*runtime)->setDataLayout(TheModule->getDataLayout());
+   for (llvm::Function& function : **runtime) {
+      function.removeFnAttr("target-cpu");
+      function.removeFnAttr("target-features");
+      function.removeFnAttr("tune-cpu");
+   }
 
+   bool failed = llvm::Linker::linkModules(*TheModule, std::move(*runtime), llvm::Linker::LinkOnlyNeeded,
+      [](llvm::Module& module, const llvm::StringSet<>& linked) {
+         llvm::internalizeModule(module, [&linked](const llvm::GlobalValue& value) {
+            return !value.hasName() || !linked.count(value.getName());
+         });
+      });
+   if (failed) fatal_error("failed to link the runtime bitcode");
+}
+
+extern "C" char* temporary_file(const char* suffix) {
+   llvm::SmallString<128> path;
+   if (std::error_code EC = llvm::sys::fs::createTemporaryFile("blang", suffix, path))
+      fatal_error("could not create a temporary file: %s", EC.message().c_str());
+   return strdup(path.c_str());
+}
+
+static void run_optimization_pipeline(llvm::Module& module, llvm::TargetMachine* targetMachine) {
    // Create analysis managers
    llvm::LoopAnalysisManager LAM;
    llvm::FunctionAnalysisManager FAM;
    llvm::CGSCCAnalysisManager CGAM;
    llvm::ModuleAnalysisManager MAM;
 
+   // -ftime-trace and -ftime-report hook in here to time each pass.
+   llvm::PassInstrumentationCallbacks PIC;
+   llvm::StandardInstrumentations SI(module.getContext(), false, ctx.verify);
+   SI.registerCallbacks(PIC, &MAM);
+
+   // Loops are unrolled and vectorized from -O2 (vectorized but for -Oz), as
+   // clang does, unless -f[no-]unroll-loops or -f[no-]vectorize say otherwise.
+   llvm::PipelineTuningOptions tuning;
+   tuning.LoopUnrolling = ctx.unrollLoops >= 0 ? ctx.unrollLoops : ctx.optimization >= 2;
+   tuning.LoopVectorization = ctx.vectorize >= 0 ? ctx.vectorize : ctx.optimization >= 2 && ctx.optimization != 5;
+   tuning.LoopInterleaving = tuning.LoopVectorization;
+   tuning.SLPVectorization = tuning.LoopVectorization;
+
    // Create pass builder
-   llvm::PassBuilder PB;
+   llvm::PassBuilder PB(targetMachine, tuning, std::nullopt, &PIC);
 
    // Register analysis passes
    PB.registerModuleAnalyses(MAM);
@@ -196,18 +392,128 @@ extern "C" void optimize() {
    PB.registerLoopAnalyses(LAM);
    PB.crossRegisterProxies(LAM, FAM, CGAM, MAM);
 
-   llvm::ModulePassManager MPM;
-   // Create optimization pipeline
+   llvm::OptimizationLevel level;
    if (ctx.optimization == 1)       // Mild optimization 
-      MPM = PB.buildPerModuleDefaultPipeline(llvm::OptimizationLevel::O1);
+      level = llvm::OptimizationLevel::O1;
    else if (ctx.optimization == 2)  // Moderate optimization
-      MPM = PB.buildPerModuleDefaultPipeline(llvm::OptimizationLevel::O2);
+      level = llvm::OptimizationLevel::O2;
    else if (ctx.optimization == 3)  // Aggressive optimization
-      MPM = PB.buildPerModuleDefaultPipeline(llvm::OptimizationLevel::O3);
+      level = llvm::OptimizationLevel::O3;
    else if (ctx.optimization == 4)  // Optimize for size
-      MPM = PB.buildPerModuleDefaultPipeline(llvm::OptimizationLevel::Os);
-   else if (ctx.optimization == 5)  // Aggressively optimize for size
-      MPM = PB.buildPerModuleDefaultPipeline(llvm::OptimizationLevel::Oz);
+      level = llvm::OptimizationLevel::Os;
+   else                             // Aggressively optimize for size
+      level = llvm::OptimizationLevel::Oz;
+
+   // Create optimization pipeline. Under -flto the module is only prepared
+   // for the linker, which optimizes again with every unit in view.
+   llvm::ModulePassManager MPM;
+   if (ctx.lto == 1 && !ctx.run)
+      MPM = PB.buildLTOPreLinkDefaultPipeline(level);
+   else if (ctx.lto == 2 && !ctx.run)
+      MPM = PB.buildThinLTOPreLinkDefaultPipeline(level);
+   else
+      MPM = PB.buildPerModuleDefaultPipeline(level);
+
+   MPM.run(module, MAM);
+}
+
+extern "C" void optimize() {
+   if (GCC_LIKELY(!ctx.optimization)) return;
+
+   // The runtime bitcode is linked under the triple and data layout set here.
+   auto targetMachine = create_target_machine();
+   prepare_module(*TheModule, *targetMachine);
+
+   // The JIT takes putchar from the runtime archive instead; see run_jit().
+   if (!ctx.run) link_runtime_bitcode();
+
+   // With -fparallel-codegen each partition is optimized on its own thread.
+   if (ctx.parallelCodegen && !ctx.lto && !ctx.emitBC && !ctx.run && !ctx.emitLLVM && !ctx.emitAssembly) return;
+
+   run_optimization_pipeline(*TheModule, targetMachine.get());
+}
 
-   MPM.run(*TheModule, MAM);
-}
\ No newline at end of file
+/**
+ * The partition count is a function of the module alone, never of the
+ * thread count, so the merged object is identical however many threads
+ * produced it.
+ */
+static const unsigned MaxCodegenPartitions = 16;
+
+/**
+ * -fparallel-codegen: split the module by function after IR generation, then
+ * optimize and emit every partition concurrently, each in a private
+ * LLVMContext with its own TargetMachine, and link the resulting objects.
+ */
+static void export_bin_parallel() {
+   using Clock = std::chrono::steady_clock;
+
+   auto targetMachine = create_target_machine();
+   prepare_module(*TheModule, *targetMachine);
+   bool link = links_executable(*targetMachine);
+
+   unsigned functions = 0;
+   for (llvm::Function& function : *TheModule)
+      if (!function.isDeclaration()) functions++;
+   unsigned partitions = std::max(1u, std::min(functions, MaxCodegenPartitions));
+
+   // Partitions share TheContext, so they travel to the workers as bitcode.
+   std::vector<llvm::SmallString<0>> bitcode;
+   llvm::SplitModule(*TheModule, partitions, [&](std::unique_ptr<llvm::Module> part) {
+      bitcode.emplace_back();
+      llvm::raw_svector_ostream stream(bitcode.back());
+      llvm::WriteBitcodeToFile(*part, stream);
+   });
+
+   llvm::ThreadPoolStrategy strategy = ctx.parallelCodegen > 0
+      ? llvm::hardware_concurrency(ctx.parallelCodegen)
+      : llvm::hardware_concurrency();
+
+   std::vector<std::string> objects(bitcode.size());
+   std::vector<double> seconds(bitcode.size());
+   Clock::time_point start = Clock::now();
+   {
+      llvm::DefaultThreadPool pool(strategy);
+      for (size_t i = 0; i < bitcode.size(); i++) {
+         pool.async([&, i] {
+            Clock::time_point begin = Clock::now();
+            if (ctx.timeTrace) llvm::timeTraceProfilerInitialize(ctx.timeTraceGranularity, "blang");
+
+            llvm::LLVMContext context;
+            auto part = llvm::parseBitcodeFile(llvm::MemoryBufferRef(bitcode[i], "partition"), context);
+            if (!part)
+               fatal_error("could not load partition %zu: %s", i, llvm::toString(part.takeError()).c_str());
+
+            auto partitionMachine = create_target_machine();
+            if (ctx.optimization) run_optimization_pipeline(**part, partitionMachine.get());
+
+            char* object = temporary_file("o");
+            emit_file(**part, *partitionMachine, object, ObjectFileType);
+            objects[i] = object;
+            free(object);
+
+            seconds[i] = std::chrono::duration<double>(Clock::now() - begin).count();
+            if (ctx.timeTrace) llvm::timeTraceProfilerFinishThread();  // Written out with the main thread's trace
+         });
+      }
+      pool.wait();
+   }
+   double wall = std::chrono::duration<double>(Clock::now() - start).count();
+
+   // Partitions go straight into the executable, or are merged for -c.
+   std::vector<const char*> paths;
+   for (const std::string& object : objects) paths.push_back(object.c_str());
+   if (link)
+      link_executable(paths.data(), (int)paths.size(), ctx.outputFilename);
+   else
+      link_relocatable(paths.data(), (int)paths.size(), ctx.outputFilename);
+   for (const std::string& object : objects) llvm::sys::fs::remove(object);
+
+   if (ctx.verbose) {
+      double serial = 0;
+      for (double s : seconds) serial += s;
+      fprintf(stderr,
+         "blang: parallel codegen: %zu partitions on %u threads, %.3fs wall, %.3fs in partitions (%.2fx over one thread)\n",
+         bitcode.size(), strategy.compute_thread_count(), wall, serial, wall > 0 ? serial / wall : 1.0);
+   }
+}
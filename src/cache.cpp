@@ -0,0 +1,187 @@
+/*
+   BLang
+   Copyright (c) 2025 William Gibbs
+
+   This software is provided 'as-is', without any express or implied
+   warranty. In no event will the authors be held liable for any damages
+   arising from the use of this software.
+
+   Permission is granted to anyone to use this software for any purpose,
+   including commercial applications, and to alter it and redistribute it
+   freely, subject to the following restrictions:
+
+   1. The origin of this software must not be misrepresented; you must not
+      claim that you wrote the original software. If you use this software
+      in a product, an acknowledgment in the product documentation would be
+      appreciated but is not required.
+   2. Altered source versions must be plainly marked as such, and must not be
+      misrepresented as being the original software.
+   3. This notice may not be removed or altered from any source distribution.
+*/
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+#include "cache.h"
+#include "context.h"
+#include "error.h"
+#include "link.h"
+
+#include <llvm/ADT/SmallString.h>
+#include <llvm/ADT/StringExtras.h>
+#include <llvm/Config/llvm-config.h>
+#include <llvm/Support/BLAKE3.h>
+#include <llvm/Support/CachePruning.h>
+#include <llvm/Support/Chrono.h>
+#include <llvm/Support/FileSystem.h>
+#include <llvm/Support/MemoryBuffer.h>
+#include <llvm/Support/Path.h>
+#include <llvm/TargetParser/Host.h>
+
+// pruneCache() only considers files with this prefix.
+static const char* CachePrefix = "llvmcache-";
+
+static std::string entry;   // path of this build's entry, empty when not caching
+
+/**
+ * Only single, regular source files producing an object or assembly file
+ * are cached. Streamed input would be consumed by hashing, and the other
+ * modes have no artifact to keep or need the front end to run.
+ */
+static bool cacheable() {
+   if (!ctx.cacheDir || ctx.inputCount != 1) return false;
+   if (ctx.run || ctx.emitLLVM || ctx.dumpAST) return false;
+   if (strcmp(ctx.inputFiles[0], "-") == 0) return false;
+   return llvm::sys::fs::is_regular_file(ctx.inputFiles[0]);
+}
+
+static void hash_field(llvm::BLAKE3& hasher, const char* name, llvm::StringRef value) {
+   hasher.update(name);
+   hasher.update("=");
+   hasher.update(value);
+   hasher.update("\n");
+}
+
+// The runtime a build would use goes into the key by content, so rebuilding it invalidates the cache.
+static void hash_runtime(llvm::BLAKE3& hasher, const char* name) {
+   char* path = find_runtime(name);
+   if (!path) {
+      hash_field(hasher, name, "");
+      return;
+   }
+   auto file = llvm::MemoryBuffer::getFile(path);
+   if (!file) fatal_error("could not read \"%s\"", path);
+   hash_field(hasher, name, (*file)->getBuffer());
+   free(path);
+}
+
+/**
+ * The key covers the source text, every option that changes the artifact,
+ * the contents of a -fprofile-use profile and of the runtime archive and
+ * bitcode, and the compiler and LLVM versions. -march=native hashes the host CPU and its features, not the
+ * word "native", so a cache shared between machines never hands out code
+ * for another CPU.
+ */
+static std::string cache_key(llvm::StringRef source) {
+   llvm::BLAKE3 hasher;
+   hash_field(hasher, "blang", BLANG_VERSION_STRING);
+   hash_field(hasher, "llvm", LLVM_VERSION_STRING);
+   hash_field(hasher, "triple", llvm::sys::getDefaultTargetTriple());
+   hash_field(hasher, "emit", ctx.emitAssembly ? "asm" : ctx.emitBC ? "bc" : ctx.compileOnly ? "obj" : "exe");
+   hash_field(hasher, "lto", std::to_string(ctx.lto));
+   hash_field(hasher, "pic", ctx.pic ? "1" : "0");
+   hash_field(hasher, "sections", std::string(ctx.functionSections ? "f" : "") + (ctx.dataSections ? "d" : "") + (ctx.gcSections ? "g" : ""));
+   hash_field(hasher, "O", std::to_string(ctx.optimization));
+   hash_field(hasher, "loops", std::to_string(ctx.unrollLoops) + "," + std::to_string(ctx.vectorize));
+   hash_field(hasher, "ssa", ctx.ssa ? "1" : "0");
+   hash_field(hasher, "global-isel", ctx.globalISel ? "1" : "0");
+   hash_field(hasher, "parallel-codegen", ctx.parallelCodegen ? "1" : "0");
+
+   if (ctx.targetCPU && strcmp(ctx.targetCPU, "native") == 0) {
+      hash_field(hasher, "cpu", llvm::sys::getHostCPUName());
+      for (const auto& feature : llvm::sys::getHostCPUFeatures())
+         hash_field(hasher, feature.second ? "+" : "-", feature.first());
+   } else {
+      hash_field(hasher, "cpu", ctx.targetCPU ? ctx.targetCPU : "");
+   }
+   hash_field(hasher, "attr", ctx.targetFeatures ? ctx.targetFeatures : "");
+
+   hash_field(hasher, "profile-generate", ctx.profileGenerate ? ctx.profileGenerate : "");
+   if (ctx.profileUse) {
+      auto profile = llvm::MemoryBuffer::getFile(ctx.profileUse);
+      if (!profile) fatal_error("could not read profile \"%s\"", ctx.profileUse);
+      hash_field(hasher, "profile-use", (*profile)->getBuffer());
+   }
+
+   hash_runtime(hasher, "libblang-rt.a");
+   hash_runtime(hasher, "blang-rt.bc");
+
+   hash_field(hasher, "source", std::to_string(source.size()));
+   hasher.update(source);
+
+   return llvm::toHex(hasher.final(), true);
+}
+
+extern "C" bool cache_restore() {
+   if (!cacheable()) return false;
+
+   auto source = llvm::MemoryBuffer::getFile(ctx.inputFiles[0]);
+   if (!source)
+      fatal_error("failed to read file \"%s\"", ctx.inputFiles[0]);
+
+   llvm::SmallString<128> path(ctx.cacheDir);
+   llvm::sys::path::append(path, CachePrefix + cache_key((*source)->getBuffer()));
+   entry = path.str().str();
+
+   // A copy rather than a hard link: the next build overwrites the output
+   // in place, which would otherwise rewrite the cached entry as well.
+   if (llvm::sys::fs::copy_file(entry, ctx.outputFilename)) {
+      if (ctx.verbose) fprintf(stderr, "blang: cache miss for \"%s\"\n", ctx.inputFiles[0]);
+      return false;
+   }
+
+   // Executables stay executable.
+   if (auto permissions = llvm::sys::fs::getPermissions(entry))
+      llvm::sys::fs::setPermissions(ctx.outputFilename, *permissions);
+
+   // Eviction is least recently used first, so a hit counts as a use.
+   int fd;
+   if (!llvm::sys::fs::openFileForWrite(entry, fd, llvm::sys::fs::CD_OpenExisting, llvm::sys::fs::OF_Append)) {
+      llvm::sys::fs::setLastAccessAndModificationTime(fd, std::chrono::system_clock::now());
+      llvm::sys::fs::file_t file = llvm::sys::fs::convertFDToNativeFile(fd);
+      llvm::sys::fs::closeFile(file);
+   }
+
+   if (ctx.verbose) fprintf(stderr, "blang: cache hit for \"%s\"\n", ctx.inputFiles[0]);
+   return true;
+}
+
+extern "C" void cache_store() {
+   if (entry.empty()) return;
+
+   if (std::error_code EC = llvm::sys::fs::create_directories(ctx.cacheDir))
+      fatal_error("could not create cache directory \"%s\": %s", ctx.cacheDir, EC.message().c_str());
+
+   // Copy then rename, so concurrent builds never see a partial entry.
+   llvm::SmallString<128> temporary;
+   int fd;
+   llvm::SmallString<128> model(ctx.cacheDir);
+   llvm::sys::path::append(model, llvm::Twine(CachePrefix) + "%%%%%%%%.tmp");
+   if (llvm::sys::fs::createUniqueFile(model, fd, temporary)) return;
+   llvm::sys::fs::file_t file = llvm::sys::fs::convertFDToNativeFile(fd);
+   llvm::sys::fs::closeFile(file);
+
+   if (auto permissions = llvm::sys::fs::getPermissions(ctx.outputFilename))
+      llvm::sys::fs::setPermissions(temporary, *permissions);
+   if (llvm::sys::fs::copy_file(ctx.outputFilename, temporary) || llvm::sys::fs::rename(temporary, entry)) {
+      llvm::sys::fs::remove(temporary);
+      return;
+   }
+
+   llvm::CachePruningPolicy policy;
+   policy.Interval = std::chrono::seconds(0);
+   policy.MaxSizeBytes = (uint64_t)ctx.cacheSize << 20;
+   llvm::pruneCache(ctx.cacheDir, policy);
+}
\ No newline at end of file
@@ -0,0 +1,44 @@
+/*
+   BLang
+   Copyright (c) 2025 William Gibbs
+
+   This software is provided 'as-is', without any express or implied
+   warranty. In no event will the authors be held liable for any damages
+   arising from the use of this software.
+
+   Permission is granted to anyone to use this software for any purpose,
+   including commercial applications, and to alter it and redistribute it
+   freely, subject to the following restrictions:
+
+   1. The origin of this software must not be misrepresented; you must not
+      claim that you wrote the original software. If you use this software
+      in a product, an acknowledgment in the product documentation would be
+      appreciated but is not required.
+   2. Altered source versions must be plainly marked as such, and must not be
+      misrepresented as being the original software.
+   3. This notice may not be removed or altered from any source distribution.
+*/
+
+#ifndef CACHE_H
+#define CACHE_H
+
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Content-addressed cache of executable, object and assembly output,
+ * enabled with -fcache-dir. cache_restore() copies a cached artifact to the
+ * output file and returns true when the build can stop there; otherwise
+ * cache_store() files the output away once it has been written.
+ */
+bool cache_restore();
+void cache_store();
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // CACHE_H
\ No newline at end of file
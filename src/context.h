@@ -22,6 +22,8 @@
 #ifndef CONTEXT_H
 #define CONTEXT_H
 
+#include <stddef.h>
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -30,11 +32,43 @@ extern "C" {
 typedef struct CompilerContext {
    bool emitAssembly;
    bool emitLLVM;
+   bool compileOnly;       // -c: stop at the object file
+   bool emitBC;            // -emit-bc
    bool dumpAST;
+   bool verbose;
+   bool run;               // -run: JIT and execute instead of writing output
+   char** programArgs;     // the program's argv under -run, starting with the source file
+   int programArgCount;
    char* outputFilename;
-   char* inputFile;
-   char* sourceText;
+   char* inputFile;        // translation unit currently being compiled
+   char** inputFiles;
+   int inputCount;
+   int jobs;               // worker processes for multi-file builds
+   int parallelCodegen;    // -fparallel-codegen threads; -1 for one per core, 0 when off
+   char* sourceText;       // mapped source, followed by two NUL bytes; NULL when streaming
+   size_t sourceLength;
+   size_t sourceLines;     // lines compiled by this process, for -v
    int optimization;
+   int unrollLoops;        // -funroll-loops: 1 on, 0 off, -1 left to the -O level
+   int vectorize;          // -fvectorize: likewise
+   bool ssa;               // -fssa: autos as SSA values instead of stack slots
+   bool globalISel;        // -fglobal-isel
+   bool verify;            // -verify: check the IR of every function and pass
+   char* targetCPU;        // -mcpu / -march, "native" for the host
+   char* targetFeatures;   // -mattr
+   bool pic;               // position independent code, linked as a static PIE
+   bool staticLink;        // -static
+   bool functionSections;  // -ffunction-sections
+   bool dataSections;      // -fdata-sections
+   bool gcSections;        // --gc-sections
+   int lto;                // -flto: 0 off, 1 full, 2 thin
+   char* profileGenerate;  // -fprofile-generate: where the program writes its counts
+   char* profileUse;       // -fprofile-use: counts to optimize with
+   bool timeTrace;         // -ftime-trace
+   int timeTraceGranularity;  // microseconds; shorter trace events are dropped
+   bool timeReport;        // -ftime-report
+   char* cacheDir;         // -fcache-dir; NULL when caching is off
+   long cacheSize;         // MiB the cache may grow to before eviction
 } CompilerContext;
 
 extern CompilerContext ctx;
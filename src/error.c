@@ -26,6 +26,7 @@
 #include "opt.h"
 
 #define RED "\033[1;31m"
+#define YELLOW "\033[1;33m"
 #define RESET "\033[0m"
 
 GCC_COLD void error(const char *text, ...) {
@@ -37,6 +38,15 @@ GCC_COLD void error(const char *text, ...) {
    va_end(args);
 }
 
+GCC_COLD void warning(const char *text, ...) {
+   va_list args;
+   va_start(args, text);
+   printf("blang: " YELLOW "warning: " RESET);
+   vprintf(text, args);
+   printf("\n");
+   va_end(args);
+}
+
 GCC_NORETURN GCC_COLD void fatal_error(const char *text, ...) {
    va_list args;
    va_start(args, text);
@@ -27,6 +27,7 @@ extern "C" {
 #endif
 
 void error(const char *text, ...);
+void warning(const char *text, ...);
 void fatal_error(const char *text, ...);
 
 #ifdef __cplusplus
@@ -0,0 +1,95 @@
+/*
+   BLang
+   Copyright (c) 2025 William Gibbs
+
+   This software is provided 'as-is', without any express or implied
+   warranty. In no event will the authors be held liable for any damages
+   arising from the use of this software.
+
+   Permission is granted to anyone to use this software for any purpose,
+   including commercial applications, and to alter it and redistribute it
+   freely, subject to the following restrictions:
+
+   1. The origin of this software must not be misrepresented; you must not
+      claim that you wrote the original software. If you use this software
+      in a product, an acknowledgment in the product documentation would be
+      appreciated but is not required.
+   2. Altered source versions must be plainly marked as such, and must not be
+      misrepresented as being the original software.
+   3. This notice may not be removed or altered from any source distribution.
+*/
+
+#include <cstdint>
+#include <cstdlib>
+
+#include "llvm.h"
+#include "context.h"
+#include "error.h"
+#include "link.h"
+
+#include <llvm/ExecutionEngine/Orc/ExecutionUtils.h>
+#include <llvm/ExecutionEngine/Orc/LLJIT.h>
+#include <llvm/ExecutionEngine/Orc/ThreadSafeModule.h>
+#include <llvm/Support/Error.h>
+
+/**
+ * -run: execute TheModule in-process with ORC instead of emitting an object.
+ * Symbols the module does not define come from the B runtime archive first,
+ * so putnumb resolves and putchar and printf keep their B meaning, then from
+ * the blang process itself. argv[0] is the source file and main() receives
+ * as many of argc and argv as it declares parameters.
+ */
+extern "C" int run_jit(int argc, char** argv) {
+   auto jit = llvm::orc::LLJITBuilder().create();
+   if (!jit)
+      fatal_error("could not create the JIT: %s", llvm::toString(jit.takeError()).c_str());
+
+   // Archive members load as the program needs them; nothing calls _start, so it never does.
+   char* runtime = find_runtime("libblang-rt.a");
+   bool hasRuntime = runtime != nullptr;
+   if (hasRuntime) {
+      auto library = llvm::orc::StaticLibraryDefinitionGenerator::Load((*jit)->getObjLinkingLayer(), runtime);
+      if (!library)
+         fatal_error("could not load \"%s\": %s", runtime, llvm::toString(library.takeError()).c_str());
+      (*jit)->getMainJITDylib().addGenerator(std::move(*library));
+      free(runtime);
+   }
+
+   auto host = llvm::orc::DynamicLibrarySearchGenerator::GetForCurrentProcess(
+      (*jit)->getDataLayout().getGlobalPrefix());
+   if (!host)
+      fatal_error("could not search the host process: %s", llvm::toString(host.takeError()).c_str());
+   (*jit)->getMainJITDylib().addGenerator(std::move(*host));
+
+   size_t params = TheModule->getFunction("main")->arg_size();
+   if (params > 2)
+      fatal_error("main() takes %zu arguments, at most 2 (argc, argv) can be passed", params);
+
+   // The JIT owns the module and its context from here on.
+   Builder.reset();
+   llvm::orc::ThreadSafeModule module(std::move(TheModule), std::move(TheContext));
+   if (llvm::Error error = (*jit)->addIRModule(std::move(module)))
+      fatal_error("could not add the module to the JIT: %s", llvm::toString(std::move(error)).c_str());
+
+   auto entry = (*jit)->lookup("main");
+   if (!entry)
+      fatal_error("could not compile main(): %s", llvm::toString(entry.takeError()).c_str());
+
+   int64_t result;
+   if (params == 0)
+      result = entry->toPtr<int64_t (*)()>()();
+   else if (params == 1)
+      result = entry->toPtr<int64_t (*)(int64_t)>()(argc);
+   else
+      result = entry->toPtr<int64_t (*)(int64_t, int64_t)>()(argc, (int64_t)(intptr_t)argv);
+
+   // What _start would do on the way out: write the runtime's buffered output.
+   if (hasRuntime) {
+      auto flush = (*jit)->lookup("__blang_flush");
+      if (!flush)
+         fatal_error("could not find __blang_flush: %s", llvm::toString(flush.takeError()).c_str());
+      flush->toPtr<void (*)()>()();
+   }
+
+   return (int)result;
+}
\ No newline at end of file
@@ -0,0 +1,140 @@
+/*
+   BLang
+   Copyright (c) 2025 William Gibbs
+
+   This software is provided 'as-is', without any express or implied
+   warranty. In no event will the authors be held liable for any damages
+   arising from the use of this software.
+
+   Permission is granted to anyone to use this software for any purpose,
+   including commercial applications, and to alter it and redistribute it
+   freely, subject to the following restrictions:
+
+   1. The origin of this software must not be misrepresented; you must not
+      claim that you wrote the original software. If you use this software
+      in a product, an acknowledgment in the product documentation would be
+      appreciated but is not required.
+   2. Altered source versions must be plainly marked as such, and must not be
+      misrepresented as being the original software.
+   3. This notice may not be removed or altered from any source distribution.
+*/
+
+#include <cstring>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "link.h"
+#include "context.h"
+#include "error.h"
+
+#include <llvm/ADT/SmallString.h>
+#include <llvm/Support/FileSystem.h>
+#include <llvm/Support/Path.h>
+#include <llvm/Support/Program.h>
+#include <llvm/Support/raw_ostream.h>
+
+#if defined(BLANG_HAVE_LLD)
+#include <lld/Common/Driver.h>
+LLD_HAS_DRIVER(elf)
+#endif
+
+static const char* RuntimeLibrary = "libblang-rt.a";
+
+/**
+ * Runtime files are looked for next to the blang executable, then in the
+ * lib directory of an installed tree, then in the build tree blang came
+ * from. Returns an empty string when `name` is in none of them.
+ */
+static std::string runtime_file(const char* name) {
+   std::string executable = llvm::sys::fs::getMainExecutable(nullptr, nullptr);
+   llvm::StringRef bin = llvm::sys::path::parent_path(executable);
+
+   llvm::SmallString<256> path(bin);
+   llvm::sys::path::append(path, name);
+   if (llvm::sys::fs::exists(path)) return path.str().str();
+
+   path = llvm::sys::path::parent_path(bin);
+   llvm::sys::path::append(path, "lib", name);
+   if (llvm::sys::fs::exists(path)) return path.str().str();
+
+#if defined(BLANG_RUNTIME_DIR)
+   path = BLANG_RUNTIME_DIR;
+   llvm::sys::path::append(path, name);
+   if (llvm::sys::fs::exists(path)) return path.str().str();
+#endif
+
+   return "";
+}
+
+extern "C" char* find_runtime(const char* name) {
+   std::string path = runtime_file(name);
+   return path.empty() ? nullptr : strdup(path.c_str());
+}
+
+static void run_linker(std::vector<std::string>& args, const char* output) {
+   std::vector<const char*> argv;
+   for (const std::string& arg : args) argv.push_back(arg.c_str());
+
+   if (ctx.verbose) {
+      fprintf(stderr, "blang: link:");
+      for (const char* arg : argv) fprintf(stderr, " %s", arg);
+      fprintf(stderr, "\n");
+   }
+
+#if defined(BLANG_HAVE_LLD)
+   lld::Result result = lld::lldMain(argv, llvm::outs(), llvm::errs(), {{lld::Gnu, &lld::elf::link}});
+   if (result.retCode != 0)
+      fatal_error("failed to link \"%s\"", output);
+#else
+   auto linker = llvm::sys::findProgramByName("ld.lld");
+   if (!linker) fatal_error("no linker found: blang was built without lld and ld.lld is not on the PATH");
+
+   std::vector<llvm::StringRef> arguments(argv.begin(), argv.end());
+   arguments[0] = *linker;
+
+   std::string message;
+   if (llvm::sys::ExecuteAndWait(*linker, arguments, std::nullopt, {}, 0, 0, &message) != 0)
+      fatal_error("failed to link \"%s\": %s", output, message.c_str());
+#endif
+}
+
+/**
+ * The runtime has no C library underneath it, so every executable is
+ * static. A PIE is linked as a static PIE, which the runtime's _start
+ * relocates itself, and -static or -fno-pic give a position dependent one.
+ */
+extern "C" void link_executable(const char** objects, int count, const char* output) {
+   std::vector<std::string> args = { "ld.lld", "-o", output, "-static" };
+
+   if (ctx.pic)
+      args.insert(args.end(), { "-pie", "--no-dynamic-linker", "-z", "text" });
+   else
+      args.push_back("-no-pie");
+
+   // -fprofile-generate descriptors are only reached through __start_blang_prof_data.
+   if (ctx.gcSections) args.insert(args.end(), { "--gc-sections", "-z", "nostart-stop-gc" });
+
+   // Bitcode inputs from -flto are optimized across units and compiled here,
+   // ThinLTO backends on up to -j threads.
+   if (ctx.lto) {
+      int level = ctx.optimization > 3 ? 2 : ctx.optimization;
+      args.push_back("--lto-O" + std::to_string(level));
+      if (ctx.lto == 2)
+         args.push_back("--thinlto-jobs=" + (ctx.jobs > 0 ? std::to_string(ctx.jobs) : std::string("all")));
+   }
+
+   for (int i = 0; i < count; i++) args.push_back(objects[i]);
+   std::string runtime = runtime_file(RuntimeLibrary);
+   if (runtime.empty()) fatal_error("could not find the B runtime (%s)", RuntimeLibrary);
+   args.push_back(runtime);
+
+   run_linker(args, output);
+}
+
+extern "C" void link_relocatable(const char** objects, int count, const char* output) {
+   std::vector<std::string> args = { "ld.lld", "-r", "-o", output };
+   for (int i = 0; i < count; i++) args.push_back(objects[i]);
+
+   run_linker(args, output);
+}
\ No newline at end of file
@@ -0,0 +1,51 @@
+/*
+   BLang
+   Copyright (c) 2025 William Gibbs
+
+   This software is provided 'as-is', without any express or implied
+   warranty. In no event will the authors be held liable for any damages
+   arising from the use of this software.
+
+   Permission is granted to anyone to use this software for any purpose,
+   including commercial applications, and to alter it and redistribute it
+   freely, subject to the following restrictions:
+
+   1. The origin of this software must not be misrepresented; you must not
+      claim that you wrote the original software. If you use this software
+      in a product, an acknowledgment in the product documentation would be
+      appreciated but is not required.
+   2. Altered source versions must be plainly marked as such, and must not be
+      misrepresented as being the original software.
+   3. This notice may not be removed or altered from any source distribution.
+*/
+
+#ifndef LINK_H
+#define LINK_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Link objects into a static ELF executable against the B runtime, honoring
+ * -static, -fno-pic and --gc-sections. lld runs in-process when blang was
+ * built with it, and an ld.lld found on the PATH otherwise.
+ */
+void link_executable(const char** objects, int count, const char* output);
+
+/**
+ * Combine objects into one relocatable object (ld -r).
+ */
+void link_relocatable(const char** objects, int count, const char* output);
+
+/**
+ * The path of a file installed with the runtime, such as blang-rt.bc, or
+ * NULL when there is none. The caller frees it.
+ */
+char* find_runtime(const char* name);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // LINK_H
\ No newline at end of file
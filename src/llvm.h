@@ -22,22 +22,26 @@
 #ifndef LLVM_WRAPPER_H
 #define LLVM_WRAPPER_H
 
+#include "ast.h"
+
 #ifdef __cplusplus
 #include <llvm/IR/LLVMContext.h>
 #include <llvm/IR/Module.h>
 #include <llvm/IR/IRBuilder.h>
 #include <llvm/IR/Value.h>
-#include <map>
 
 extern std::unique_ptr<llvm::LLVMContext> TheContext;
 extern std::unique_ptr<llvm::IRBuilder<>> Builder;
 extern std::unique_ptr<llvm::Module> TheModule;
-extern std::map<std::string, llvm::Value *> NamedValues;
 
 extern "C" {
 #endif
 
-void generate_llvm_ir();
+void begin_llvm_ir();
+void generate_llvm_ir(ASTIndex definition);
+void finish_llvm_ir();
+void internalize_program();
+void verify_entry_point();
 void initialize_llvm();
 
 void optimize();
@@ -45,6 +49,11 @@ void optimize();
 void export_ir();
 void export_asm();
 void export_bin();
+void export_bc(const char* path);
+
+void link_bc(const char* path);
+int run_jit(int argc, char** argv);
+char* temporary_file(const char* suffix);
 
 #ifdef __cplusplus
 }
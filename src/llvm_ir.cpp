@@ -24,13 +24,27 @@
 #include <llvm/IR/IRBuilder.h>
 #include <llvm/IR/Value.h>
 #include <llvm/IR/DerivedTypes.h>
-#include <map>
+#include <llvm/IR/MDBuilder.h>
+#include <llvm/IR/CFG.h>
+#include <llvm/IR/ValueHandle.h>
+#include <llvm/IR/Verifier.h>
+#include <llvm/ADT/DenseMap.h>
+#include <llvm/ADT/SmallPtrSet.h>
+#include <llvm/ADT/SmallVector.h>
+#include <llvm/ProfileData/InstrProf.h>
+#include <llvm/ProfileData/ProfileCommon.h>
+#include <llvm/Transforms/Utils/ModuleUtils.h>
+#include <algorithm>
+#include <vector>
 #include <sstream>
 #include <string>
 #include <cstring>
 #include <iostream>
 
 #include "llvm.h"
+#include "timing.h"
+#include "profile.h"
+#include "context.h"
 #include "ast.h"
 #include "error.h"
 #include "opt.h"
@@ -39,181 +53,721 @@ std::unique_ptr<llvm::LLVMContext> TheContext;
 std::unique_ptr<llvm::IRBuilder<>> Builder;
 std::unique_ptr<llvm::Module> TheModule;
 
-std::map<std::string, llvm::Value *> NamedValues;
-std::map<std::string, llvm::Value *> ExtrnValues;
+/**
+ * A dense, symbol-indexed table of values that only live as long as the
+ * function being generated. Every entry remembers the epoch it was written
+ * in, so moving on to the next function is a single increment instead of a
+ * clear, no matter how many locals the previous one had.
+ */
+template <typename T>
+class ScopeTable {
+   struct Entry {
+      T* value;
+      uint32_t epoch;
+   };
+   std::vector<Entry> entries;
+   uint32_t epoch = 1;
+
+public:
+   void reset() {
+      epoch++;
+      if (entries.size() < symbol_count()) entries.resize(symbol_count(), Entry{nullptr, 0});
+   }
+
+   T* lookup(Symbol symbol) const {
+      const Entry& entry = entries[symbol];
+      return entry.epoch == epoch ? entry.value : nullptr;
+   }
+
+   void set(Symbol symbol, T* value) { entries[symbol] = Entry{value, epoch}; }
+};
+
+/**
+ * A symbol-indexed table for values that live as long as the module.
+ */
+template <typename T>
+class SymbolTable {
+   std::vector<T*> entries;
 
-std::map<std::string, llvm::Function *> FunctionValues;
-std::map<std::string, llvm::BasicBlock *> BasicBlockValues;
+public:
+   T* lookup(Symbol symbol) const { return symbol < entries.size() ? entries[symbol] : nullptr; }
+
+   void set(Symbol symbol, T* value) {
+      if (symbol >= entries.size()) entries.resize(symbol_count(), nullptr);
+      entries[symbol] = value;
+   }
+
+   // Symbols are numbered afresh for every unit, and the values belong to its module.
+   void reset() { entries.clear(); }
+};
+
+ScopeTable<llvm::Value> NamedValues;              // auto and extrn names visible in the current function
+ScopeTable<llvm::BasicBlock> BasicBlockValues;    // labels of the current function
+
+SymbolTable<llvm::GlobalVariable> GlobalValues;
+SymbolTable<llvm::Function> FunctionValues;
+
+// Vector storage is aligned to a cache line, and the widest vector register the targets have (AVX-512).
+static const unsigned VectorAlignment = 64;
 
 GCC_HOT static inline llvm::Value* value_of(llvm::Value* alloca) {
    return Builder->CreateLoad(llvm::Type::getInt64Ty(*TheContext), alloca, "load");
 }
 
-/** 
- * Stores whether a function being processed includes a return statement at the end.
- * If not, return(undef); is added.
+GCC_HOT static inline llvm::Value* variable(Symbol name) {
+   llvm::Value* address = NamedValues.lookup(name);
+   if (GCC_UNLIKELY(!address)) fatal_error("\"%s\" undefined", symbol_name(name));
+   return address;
+}
+
+// What an extrn names: a function seen so far, or else an external word.
+static llvm::GlobalValue* global_variable(Symbol name) {
+   if (llvm::Function* function = FunctionValues.lookup(name)) return function;
+
+   llvm::GlobalVariable* global = GlobalValues.lookup(name);
+   if (!global) {
+      global = new llvm::GlobalVariable(
+         *TheModule,
+         llvm::Type::getInt64Ty(*TheContext),
+         false,
+         llvm::GlobalValue::ExternalLinkage,
+         nullptr,
+         symbol_name(name)
+      );
+      GlobalValues.set(name, global);
+   }
+   return global;
+}
+
+/**
+ * Stack slots go at the top of the entry block, ahead of a placeholder
+ * instruction removed once the function is complete. A declaration inside a
+ * loop then does not grow the stack each iteration, and mem2reg can promote
+ * every slot.
+ */
+static llvm::Instruction* AllocaPoint;
+
+/**
+ * Self calls in return position, made musttail so recursion runs in
+ * constant stack. Whether that is safe is only known once the whole
+ * function has been generated: an auto vector's address may be passed on.
+ */
+static llvm::SmallVector<llvm::CallInst*, 4> SelfTailCalls;
+
+// Whether the address of a stack slot is taken, so a call reusing the frame could still read it.
+static bool frame_escapes(llvm::Function* function) {
+   for (llvm::Instruction& instruction : function->getEntryBlock()) {
+      auto* slot = llvm::dyn_cast<llvm::AllocaInst>(&instruction);
+      if (!slot) continue;
+      for (llvm::User* user : slot->users()) {
+         if (llvm::isa<llvm::LoadInst>(user)) continue;
+         auto* store = llvm::dyn_cast<llvm::StoreInst>(user);
+         if (store && store->getPointerOperand() == slot) continue;
+         return true;
+      }
+   }
+   return false;
+}
+
+/**
+ * -fssa keeps autos and parameters out of memory altogether: they are built
+ * straight into SSA form while the code is generated, as in Braun et al.,
+ * "Simple and Efficient Construction of Static Single Assignment Form"
+ * (CC 2013). The last value written to a local is recorded per block; a read
+ * in a block without one looks through the predecessors and places phis
+ * where they meet. Blocks that may still gain predecessors (labels, loop
+ * headers) are unsealed, and their phis get operands once they are sealed.
+ * Phis that merge only one value are removed again, so even -O0 code keeps
+ * locals in registers.
+ */
+ScopeTable<llvm::Value> SSAValues;                // -fssa locals and their value on entry to the function
+
+static llvm::DenseMap<std::pair<llvm::BasicBlock*, Symbol>, llvm::WeakTrackingVH> CurrentDefs;
+static llvm::DenseMap<llvm::BasicBlock*, llvm::SmallVector<std::pair<Symbol, llvm::PHINode*>, 4>> IncompletePhis;
+static llvm::SmallPtrSet<llvm::BasicBlock*, 32> SealedBlocks;
+
+static llvm::Value* read_local(Symbol name, llvm::BasicBlock* block);
+
+static llvm::PHINode* new_phi(Symbol name, llvm::BasicBlock* block) {
+   llvm::IRBuilder<> builder(block, block->begin());
+   return builder.CreatePHI(Builder->getInt64Ty(), 2, symbol_name(name));
+}
+
+static llvm::Value* remove_trivial_phi(llvm::PHINode* phi) {
+   llvm::Value* same = nullptr;
+   for (llvm::Value* operand : phi->incoming_values()) {
+      if (operand == same || operand == phi) continue;
+      if (same) return phi;                  // merges two values
+      same = operand;
+   }
+   if (!same) same = llvm::UndefValue::get(phi->getType());  // unreachable, or only ever itself
+
+   // Phis using this one may have become trivial in turn. They are held
+   // weakly, as removing one can remove another further down the list.
+   llvm::SmallVector<llvm::WeakVH, 8> users;
+   for (llvm::User* user : phi->users())
+      if (user != phi && llvm::isa<llvm::PHINode>(user)) users.push_back(user);
+
+   phi->replaceAllUsesWith(same);
+   phi->eraseFromParent();
+
+   for (llvm::WeakVH& user : users)
+      if (auto* other = llvm::dyn_cast_or_null<llvm::PHINode>(static_cast<llvm::Value*>(user))) remove_trivial_phi(other);
+   return same;
+}
+
+static llvm::Value* add_phi_operands(Symbol name, llvm::PHINode* phi) {
+   for (llvm::BasicBlock* pred : llvm::predecessors(phi->getParent()))
+      phi->addIncoming(read_local(name, pred), pred);
+   return remove_trivial_phi(phi);
+}
+
+static llvm::Value* read_local(Symbol name, llvm::BasicBlock* block) {
+   auto def = CurrentDefs.find({block, name});
+   if (def != CurrentDefs.end()) return def->second;
+
+   llvm::Value* value;
+   if (block->isEntryBlock()) {
+      value = SSAValues.lookup(name);
+   } else if (!SealedBlocks.count(block)) {
+      llvm::PHINode* phi = new_phi(name, block);
+      IncompletePhis[block].push_back({name, phi});
+      value = phi;
+   } else if (llvm::BasicBlock* pred = block->getSinglePredecessor()) {
+      value = read_local(name, pred);
+   } else {
+      llvm::PHINode* phi = new_phi(name, block);
+      CurrentDefs[{block, name}] = phi;       // ends the search around loops
+      value = add_phi_operands(name, phi);
+   }
+   CurrentDefs[{block, name}] = value;
+   return value;
+}
+
+// No more predecessors will be added to block.
+static void seal_block(llvm::BasicBlock* block) {
+   if (!ctx.ssa) return;
+   SealedBlocks.insert(block);
+
+   auto incomplete = IncompletePhis.find(block);
+   if (incomplete == IncompletePhis.end()) return;
+   auto phis = std::move(incomplete->second);
+   IncompletePhis.erase(incomplete);
+   for (auto& [name, phi] : phis) add_phi_operands(name, phi);
+}
+
+// Binds an auto or parameter; initial is its value on entry to the function, if it has one.
+static void declare_local(Symbol name, llvm::Value* initial) {
+   if (ctx.ssa) {
+      SSAValues.set(name, initial ? initial : llvm::UndefValue::get(Builder->getInt64Ty()));
+      return;
+   }
+
+   llvm::IRBuilder<> entry(AllocaPoint);
+   llvm::AllocaInst* slot = entry.CreateAlloca(Builder->getInt64Ty(), nullptr, symbol_name(name));
+   if (initial) entry.CreateStore(initial, slot);
+   NamedValues.set(name, slot);
+}
+
+static bool is_local(Symbol name) {
+   if (ctx.ssa) return SSAValues.lookup(name) != nullptr;
+   return llvm::isa_and_nonnull<llvm::AllocaInst>(NamedValues.lookup(name));
+}
+
+GCC_HOT static llvm::Value* read_variable(Symbol name) {
+   if (ctx.ssa && SSAValues.lookup(name)) return read_local(name, Builder->GetInsertBlock());
+   return value_of(variable(name));
+}
+
+GCC_HOT static void write_variable(Symbol name, llvm::Value* value) {
+   if (ctx.ssa && SSAValues.lookup(name))
+      CurrentDefs[{Builder->GetInsertBlock(), name}] = value;
+   else
+      Builder->CreateStore(value, variable(name));
+}
+
+// Labels may be jumped to before they are defined, so blocks are created on first mention.
+static llvm::BasicBlock* label_block(Symbol name) {
+   llvm::BasicBlock* block = BasicBlockValues.lookup(name);
+   if (!block) {
+      block = llvm::BasicBlock::Create(*TheContext, symbol_name(name), Builder->GetInsertBlock()->getParent());
+      BasicBlockValues.set(name, block);
+   }
+   return block;
+}
+
+/**
+ * -fprofile-generate and -fprofile-use. Counters are numbered as profile.h
+ * describes; while a function is generated they are addressed through a
+ * placeholder global that becomes an array of the final size at its end.
+ */
+static Profile LoadedProfile;                        // -fprofile-use counts
+static llvm::GlobalVariable* ProfileCounters;        // -fprofile-generate placeholder
+static const ProfileRecord* ProfileCounts;           // the current function's counts, if any
+static std::vector<llvm::BranchInst*> ProfileBranches;
+static uint32_t ProfileNext;
+static uint64_t ProfileHash;
+
+static void profile_increment(uint32_t index, llvm::Value* amount) {
+   llvm::Value* counter = Builder->CreateConstInBoundsGEP1_64(Builder->getInt64Ty(), ProfileCounters, index, "prof_counter");
+   llvm::Value* count = Builder->CreateLoad(Builder->getInt64Ty(), counter, "prof_count");
+   Builder->CreateStore(Builder->CreateAdd(count, amount), counter);
+}
+
+static void profile_function_begin() {
+   ProfileNext = 1;                          // counter 0 counts calls
+   ProfileHash = 14695981039346656037ULL;
+   ProfileBranches.clear();
+   ProfileCounts = nullptr;
+
+   if (ctx.profileGenerate) {
+      ProfileCounters = new llvm::GlobalVariable(*TheModule, Builder->getInt64Ty(), false,
+         llvm::GlobalValue::PrivateLinkage, nullptr, "prof_placeholder");
+      profile_increment(0, Builder->getInt64(1));
+   }
+   if (ctx.profileUse)
+      ProfileCounts = profile_find(&LoadedProfile, Builder->GetInsertBlock()->getParent()->getName().str().c_str());
+}
+
+// A counter pair for an if or while condition; `kind` feeds the shape hash.
+static uint32_t profile_site(char kind) {
+   ProfileHash = (ProfileHash ^ (uint8_t)kind) * 1099511628211ULL;
+   uint32_t site = ProfileNext;
+   ProfileNext += 2;
+   return site;
+}
+
+/**
+ * Branch on `cond`, counting the test under -fprofile-generate and
+ * weighting the edges from the profile under -fprofile-use.
  */
-static bool functionDoesReturn = false;
+static llvm::BranchInst* conditional_branch(llvm::Value* cond, llvm::BasicBlock* taken, llvm::BasicBlock* untaken, uint32_t site) {
+   if (ctx.profileGenerate) {
+      profile_increment(site, Builder->getInt64(1));
+      profile_increment(site + 1, Builder->CreateZExt(cond, Builder->getInt64Ty(), "prof_taken"));
+   }
 
-GCC_HOT static llvm::Value* add_expression(ASTNode* node) {
+   llvm::MDNode* weights = nullptr;
+   if (ProfileCounts && site + 1 < ProfileCounts->count) {
+      uint64_t tested = ProfileCounts->counters[site];
+      uint64_t yes = std::min(ProfileCounts->counters[site + 1], tested);
+      uint64_t no = tested - yes;
+      while (yes > UINT32_MAX || no > UINT32_MAX) { yes >>= 1; no >>= 1; }
+      weights = llvm::MDBuilder(*TheContext).createBranchWeights((uint32_t)yes, (uint32_t)no);
+   }
 
+   llvm::BranchInst* branch = Builder->CreateCondBr(cond, taken, untaken, weights);
+   if (weights) ProfileBranches.push_back(branch);
+   return branch;
+}
+
+static void profile_function_end(llvm::Function* function) {
+   if (ctx.profileGenerate) {
+      llvm::Type* i64 = Builder->getInt64Ty();
+      llvm::ArrayType* type = llvm::ArrayType::get(i64, ProfileNext);
+      auto* counters = new llvm::GlobalVariable(*TheModule, type, false, llvm::GlobalValue::PrivateLinkage,
+         llvm::ConstantAggregateZero::get(type), "__blang_prof_cnts_" + function->getName());
+      ProfileCounters->replaceAllUsesWith(counters);
+      ProfileCounters->eraseFromParent();
+
+      // The descriptor the runtime walks at exit, see runtime/profile.c.
+      llvm::Constant* name = Builder->CreateGlobalString(function->getName(), "__blang_prof_name_" + function->getName(), 0, TheModule.get());
+      llvm::StructType* dataType = llvm::StructType::get(*TheContext, { name->getType(), i64, i64, i64, counters->getType() });
+      llvm::Constant* fields[] = {
+         name,
+         llvm::ConstantInt::get(i64, function->getName().size()),
+         llvm::ConstantInt::get(i64, ProfileHash),
+         llvm::ConstantInt::get(i64, ProfileNext),
+         counters,
+      };
+      auto* data = new llvm::GlobalVariable(*TheModule, dataType, true, llvm::GlobalValue::PrivateLinkage,
+         llvm::ConstantStruct::get(dataType, fields), "__blang_prof_data_" + function->getName());
+      data->setSection("blang_prof_data");
+      data->setAlignment(llvm::Align(8));
+      llvm::appendToCompilerUsed(*TheModule, { data });
+   }
+
+   if (!ProfileCounts) return;
+   if (ProfileCounts->hash != ProfileHash || ProfileCounts->count != ProfileNext) {
+      warning("profile for %s is out of date and was not used", function->getName().str().c_str());
+      for (llvm::BranchInst* branch : ProfileBranches) branch->setMetadata(llvm::LLVMContext::MD_prof, nullptr);
+      return;
+   }
+   function->setEntryCount(ProfileCounts->counters[0]);
+}
+
+static void profile_module_begin() {
+   if (ctx.profileGenerate && !TheModule->getNamedGlobal("__blang_profile_path")) {
+      llvm::Constant* path = llvm::ConstantDataArray::getString(*TheContext, ctx.profileGenerate);
+      auto* global = new llvm::GlobalVariable(*TheModule, path->getType(), true,
+         llvm::GlobalValue::WeakODRLinkage, path, "__blang_profile_path");
+      global->setAlignment(llvm::Align(1));
+   }
+
+   if (ctx.profileUse && !LoadedProfile.length && !profile_read(&LoadedProfile, ctx.profileUse))
+      fatal_error("could not read profile \"%s\"", ctx.profileUse);
+}
+
+/**
+ * The profile summary tells the optimizer the entry counts and branch
+ * weights are real, and which counts are hot.
+ */
+static void profile_module_end() {
+   if (!ctx.profileUse) return;
+
+   llvm::InstrProfSummaryBuilder summary(llvm::ProfileSummaryBuilder::DefaultCutoffs);
+   for (size_t i = 0; i < LoadedProfile.length; i++) {
+      const ProfileRecord& record = LoadedProfile.records[i];
+      if (!TheModule->getFunction(record.name) || record.count == 0) continue;
+      summary.addRecord(llvm::InstrProfRecord(std::vector<uint64_t>(record.counters, record.counters + record.count)));
+   }
+   TheModule->setProfileSummary(summary.getSummary()->getMD(*TheContext), llvm::ProfileSummary::PSK_Instr);
+}
+
+static llvm::FunctionType* function_type(uint32_t params) {
+   std::vector<llvm::Type*> list(params, Builder->getInt64Ty());
+   return llvm::FunctionType::get(Builder->getInt64Ty(), list, false);
+}
+
+/**
+ * Definitions arrive one at a time from the parser, so a name may be used
+ * before its function is seen. An extrn or an initial value that got there
+ * first took it for an external word; the function takes its place.
+ */
+static llvm::GlobalVariable* external_declaration(Symbol name) {
+   llvm::GlobalVariable* external = GlobalValues.lookup(name);
+   if (!external || !external->isDeclaration()) return nullptr;
+   GlobalValues.set(name, nullptr);
+   return external;
+}
+
+static llvm::Function* create_function(Symbol name, uint32_t params, llvm::GlobalValue* previous) {
+   llvm::Function* function = llvm::Function::Create(function_type(params), llvm::Function::ExternalLinkage,
+      "", *TheModule);
+   if (previous) {
+      previous->replaceAllUsesWith(function);
+      function->takeName(previous);
+      previous->eraseFromParent();
+   } else {
+      function->setName(symbol_name(name));
+   }
+   FunctionValues.set(name, function);
+   return function;
+}
+
+/**
+ * A function is declared by its first call, with as many parameters as the
+ * call has arguments. It may be the runtime's putchar, a function in
+ * another file, or one defined further down this file.
+ */
+static llvm::Function* declare_function(Symbol name, uint32_t params) {
+   llvm::Function* function = FunctionValues.lookup(name);
+   if (function) return function;
+
+   // An extrn earlier in the body being compiled may name the word replaced here.
+   llvm::GlobalVariable* external = external_declaration(name);
+   bool bound = external && NamedValues.lookup(name) == external;
+   function = create_function(name, params, external);
+   if (bound) NamedValues.set(name, function);
+   return function;
+}
+
+/**
+ * The definition replaces a declaration made with another number of
+ * parameters. Calls keep their own function type, which is all a call
+ * through an opaque pointer needs.
+ */
+static llvm::Function* define_function(Symbol name, uint32_t params) {
+   llvm::Function* declared = FunctionValues.lookup(name);
+   if (declared && !declared->isDeclaration())
+      fatal_error("function \"%s\" is defined twice", symbol_name(name));
+   if (declared && declared->getFunctionType() == function_type(params))
+      return declared;
+   if (declared) return create_function(name, params, declared);
+   return create_function(name, params, external_declaration(name));
+}
+
+static llvm::Value* add_expression(ASTIndex index);
+static llvm::CallInst* add_call(ASTIndex index);
+
+/**
+ * A vector's name holds the address of its first word, and v[i] is the word
+ * i words past it; v[i][j] indexes the vector whose address is in v[i].
+ * The in-bounds word-sized steps are what lets the loop vectorizer see
+ * consecutive accesses.
+ */
+GCC_HOT static llvm::Value* element_address(ASTIndex index) {
+   ASTNode* node = ast_node(index);
+   const ASTIndex* subscripts = ast_list_items(node->list.items);
+
+   llvm::Value* word = read_variable(node->list.title);
+   llvm::Value* address = nullptr;
+   for (uint32_t i = 0; i < ast_list_length(node->list.items); i++) {
+      if (address) word = value_of(address);
+      llvm::Value* vector = Builder->CreateIntToPtr(word, Builder->getPtrTy(), "vector");
+      address = Builder->CreateInBoundsGEP(Builder->getInt64Ty(), vector, add_expression(subscripts[i]), "element");
+   }
+   return address;
+}
+
+static inline bool is_operator(uint8_t type) {
+   return (type >= _ADD && type <= _NEQUALS) || type == _NOT || type == _NEGATIVE;
+}
+
+static llvm::Value* add_operator(ASTNode* node, llvm::Value* left, llvm::Value* right) {
    switch (node->type) {
-      case ASTNode::_ADD:
-         return Builder->CreateAdd(add_expression(node->factors.left), add_expression(node->factors.right), "addtmp");
-         break;
-      case ASTNode::_SUBTRACT:
-         return Builder->CreateSub(add_expression(node->factors.left), add_expression(node->factors.right), "subtmp");
-         break;
-      case ASTNode::_MULTIPLY:
-         return Builder->CreateMul(add_expression(node->factors.left), add_expression(node->factors.right), "multmp");
-         break;
-      case ASTNode::_DIVIDE:
-         return Builder->CreateSDiv(add_expression(node->factors.left), add_expression(node->factors.right), "sdivtmp");
-         break;
-      case ASTNode::_GTEQ:
-         {
-            llvm::Value* cmp = Builder->CreateICmpSGE(add_expression(node->factors.left), add_expression(node->factors.right), "sgetmp");
-            return Builder->CreateZExt(cmp, llvm::Type::getInt64Ty(*TheContext), "i64_bool");
-            break;
-         }
-      case ASTNode::_LTEQ:
-         {
-            llvm::Value* cmp = Builder->CreateICmpSLE(add_expression(node->factors.left), add_expression(node->factors.right), "sletmp");
-            return Builder->CreateZExt(cmp, llvm::Type::getInt64Ty(*TheContext), "i64_bool");
-            break;
-         }
-      case ASTNode::_GREATER:
-         {
-            llvm::Value* cmp = Builder->CreateICmpSGT(add_expression(node->factors.left), add_expression(node->factors.right), "sgttmp");
-            return Builder->CreateZExt(cmp, llvm::Type::getInt64Ty(*TheContext), "i64_bool");
-            break;
-         }
-      case ASTNode::_LESS:
-         {
-            llvm::Value* cmp = Builder->CreateICmpSLT(add_expression(node->factors.left), add_expression(node->factors.right), "slttmp");
-            return Builder->CreateZExt(cmp, llvm::Type::getInt64Ty(*TheContext), "i64_bool");
-            break;
-         }
-      case ASTNode::_EQUALS:
-         {
-            llvm::Value* cmp = Builder->CreateICmpEQ(add_expression(node->factors.left), add_expression(node->factors.right), "eqtmp");
-            return Builder->CreateZExt(cmp, llvm::Type::getInt64Ty(*TheContext), "i64_bool");
-            break;
-         }
-      case ASTNode::_NEQUALS:
-         {
-            llvm::Value* cmp = Builder->CreateICmpNE(add_expression(node->factors.left), add_expression(node->factors.right), "netmp");
-            return Builder->CreateZExt(cmp, llvm::Type::getInt64Ty(*TheContext), "i64_bool");
-            break;
-         }
-      case ASTNode::_FUNCTION_CALL:
-         break;
-      case ASTNode::_NOT:
+      case _ADD:
+         return Builder->CreateAdd(left, right, "addtmp");
+      case _SUBTRACT:
+         return Builder->CreateSub(left, right, "subtmp");
+      case _MULTIPLY:
+         return Builder->CreateMul(left, right, "multmp");
+      case _DIVIDE:
+         return Builder->CreateSDiv(left, right, "sdivtmp");
+      case _GTEQ:
+         return Builder->CreateZExt(Builder->CreateICmpSGE(left, right, "sgetmp"), llvm::Type::getInt64Ty(*TheContext), "i64_bool");
+      case _LTEQ:
+         return Builder->CreateZExt(Builder->CreateICmpSLE(left, right, "sletmp"), llvm::Type::getInt64Ty(*TheContext), "i64_bool");
+      case _GREATER:
+         return Builder->CreateZExt(Builder->CreateICmpSGT(left, right, "sgttmp"), llvm::Type::getInt64Ty(*TheContext), "i64_bool");
+      case _LESS:
+         return Builder->CreateZExt(Builder->CreateICmpSLT(left, right, "slttmp"), llvm::Type::getInt64Ty(*TheContext), "i64_bool");
+      case _EQUALS:
+         return Builder->CreateZExt(Builder->CreateICmpEQ(left, right, "eqtmp"), llvm::Type::getInt64Ty(*TheContext), "i64_bool");
+      case _NEQUALS:
+         return Builder->CreateZExt(Builder->CreateICmpNE(left, right, "netmp"), llvm::Type::getInt64Ty(*TheContext), "i64_bool");
+      case _NOT:
          {
             llvm::Value* not_value = Builder->CreateICmpEQ(
-               add_expression(node->inner), 
+               left, 
                llvm::ConstantInt::get(*TheContext, llvm::APInt(64, 0)),
                "not_tmp"
             );
             return Builder->CreateZExt(not_value, llvm::Type::getInt64Ty(*TheContext), "i64_not");
-            break;
          }
-      case ASTNode::_INC:
+      case _NEGATIVE:
+         return Builder->CreateNeg(left, "negtmp");
+      default:
+         return nullptr;
+   }
+}
+
+// Everything but the operators: the leaves of an expression tree.
+static llvm::Value* add_operand(ASTIndex index) {
+   ASTNode* node = ast_node(index);
+
+   switch (node->type) {
+      case _FUNCTION_CALL:
+         return add_call(index);
+      case _ARRAY_REF:
+         return value_of(element_address(index));
+      case _INC:
          {
             llvm::Value* inc = Builder->CreateAdd(
-               value_of(NamedValues[node->string]), 
+               read_variable(node->symbol), 
                llvm::ConstantInt::get(*TheContext, llvm::APInt(64, 1)), 
                "inctmp");
-            Builder->CreateStore(inc, NamedValues[node->string]);
+            write_variable(node->symbol, inc);
             return Builder->CreateSub(inc, llvm::ConstantInt::get(*TheContext, llvm::APInt(64, 1)), "lesser_inc");
          }
-      case ASTNode::_DEC:
+      case _DEC:
          {
             llvm::Value* dec = Builder->CreateSub(
-               value_of(NamedValues[node->string]), 
+               read_variable(node->symbol), 
                llvm::ConstantInt::get(*TheContext, llvm::APInt(64, 1)), 
                "dectmp");
-            Builder->CreateStore(dec, NamedValues[node->string]);
+            write_variable(node->symbol, dec);
             return Builder->CreateAdd(dec, llvm::ConstantInt::get(*TheContext, llvm::APInt(64, 1)), "greater_dec");
          }
-         break;
-      case ASTNode::_NUMBER:
+      case _NUMBER:
          return llvm::ConstantInt::get(llvm::Type::getInt64Ty(*TheContext), node->integer);
-         break;
-      case ASTNode::_VARIABLE:
-         return value_of(NamedValues[node->string]);
-         break;
+      case _VARIABLE:
+         return read_variable(node->symbol);
       default:
-         break;
+         return nullptr;
    }
-   return nullptr;
 }
 
-GCC_HOT static void add_statement(ASTNode* node) {
+/**
+ * Operators are lowered from an explicit work stack instead of by recursion,
+ * so a generated expression a hundred thousand operators deep costs heap
+ * rather than native stack. Operands are emitted left to right. Calls and
+ * subscripts still recurse into their arguments, one frame per nested call.
+ */
+GCC_HOT static llvm::Value* add_expression(ASTIndex index) {
+   struct Pending {
+      ASTIndex index;
+      bool expanded;       // operands already queued; combine them now
+   };
+   llvm::SmallVector<Pending, 32> work;
+   llvm::SmallVector<llvm::Value*, 32> values;
+
+   work.push_back({ index, false });
+   while (!work.empty()) {
+      Pending item = work.pop_back_val();
+      ASTNode* node = ast_node(item.index);
+
+      if (!is_operator(node->type)) {
+         values.push_back(add_operand(item.index));
+      }
+      else if (!item.expanded) {
+         work.push_back({ item.index, true });
+         if (node->type == _NOT || node->type == _NEGATIVE) {
+            work.push_back({ node->inner, false });
+         }
+         else {
+            work.push_back({ node->factors.right, false });
+            work.push_back({ node->factors.left, false });
+         }
+      }
+      else if (node->type == _NOT || node->type == _NEGATIVE) {
+         values.back() = add_operator(node, values.back(), nullptr);
+      }
+      else {
+         llvm::Value* right = values.pop_back_val();
+         values.back() = add_operator(node, values.back(), right);
+      }
+   }
+   return values.back();
+}
+
+static void add_statements(ASTList list);
+
+/**
+ * Identifies a loop to the optimizer. An explicit -fno-unroll-loops or
+ * -fno-vectorize is recorded on the loop as well, so it still holds when
+ * the linker optimizes the bitcode under -flto.
+ */
+static llvm::MDNode* loop_metadata() {
+   llvm::SmallVector<llvm::Metadata*, 3> operands = { nullptr };
+   if (ctx.unrollLoops == 0)
+      operands.push_back(llvm::MDNode::get(*TheContext, llvm::MDString::get(*TheContext, "llvm.loop.unroll.disable")));
+   if (ctx.vectorize == 0)
+      operands.push_back(llvm::MDNode::get(*TheContext, {
+         llvm::MDString::get(*TheContext, "llvm.loop.vectorize.enable"),
+         llvm::ConstantAsMetadata::get(Builder->getFalse())
+      }));
+
+   llvm::MDNode* loop = llvm::MDNode::getDistinct(*TheContext, operands);
+   loop->replaceOperandWith(0, loop);
+   return loop;
+}
+
+/**
+ * Arguments are words, evaluated left to right. A call is made with the
+ * prototype of its own argument count: B does not check that against the
+ * definition, and the runtime's printf takes fewer words than it declares.
+ */
+static llvm::CallInst* add_call(ASTIndex index) {
+   ASTNode* node = ast_node(index);
+   uint32_t count = ast_list_length(node->list.items);
+   const ASTIndex* items = ast_list_items(node->list.items);
+
+   std::vector<llvm::Value*> args;
+   args.reserve(count);
+   for (uint32_t i = 0; i < count; i++)
+      args.push_back(add_expression(items[i]));
+
+   // An auto holds the address of the function to call.
+   if (is_local(node->list.title)) {
+      llvm::Value* callee = Builder->CreateIntToPtr(read_variable(node->list.title), Builder->getPtrTy(), "callee");
+      return Builder->CreateCall(function_type(count), callee, args, "calltmp");
+   }
+
+   llvm::Function* function = declare_function(node->list.title, count);
+   llvm::CallInst* call = Builder->CreateCall(function_type(count), function, args, "calltmp");
+   call->setCallingConv(function->getCallingConv());
+   return call;
+}
+
+GCC_HOT static void add_statement(ASTIndex index) {
+   ASTNode* node = ast_node(index);
 
    switch (node->type) {
-      case ASTNode::STOP: return;
-      case ASTNode::_AUTO:
-      case ASTNode::_EXTRN:
-         add_statement(node->list.next);
-         add_statement(node->successor);
+      case STOP: return;
+      case _AUTO:
+      case _EXTRN:
+         add_statements(node->list.items);
          break;
-      case ASTNode::_VARIABLE:
+      case _VARIABLE:
          {
-            if (node->list.variableType == VariableType::VAR_AUTO) {
-               NamedValues[node->list.title] = Builder->CreateAlloca(llvm::Type::getInt64Ty(*TheContext), nullptr, node->list.title);
-               add_statement(node->list.next);
-            }
-            else if (node->list.variableType == VariableType::VAR_EXTRN) {
-               ExtrnValues[node->list.title] = new llvm::GlobalVariable(
-                  *TheModule,
-                  llvm::Type::getInt64Ty(*TheContext),
-                  false,
-                  llvm::GlobalValue::ExternalLinkage,
-                  nullptr,
-                  node->list.title
-               );
+            if (node->variableType == VariableType::VAR_AUTO) {
+               declare_local(node->symbol, nullptr);
+            } else if (node->variableType == VariableType::VAR_EXTRN) {
+               NamedValues.set(node->symbol, global_variable(node->symbol));
+               SSAValues.set(node->symbol, nullptr);
             }
             break;
          }
-      case ASTNode::_ASSIGNMENT:
+      case _ARRAY:
          {
-            Builder->CreateStore(add_expression(node->list.next), NamedValues[node->list.title]);
-            add_statement(node->successor);
+            // Stack storage aligned like an external vector's; the name is a word holding its address.
+            if (node->variableType != VariableType::VAR_AUTO)
+               fatal_error("extrn \"%s\" cannot give a vector size", symbol_name(node->array.title));
+
+            llvm::IRBuilder<> entry(AllocaPoint);
+            llvm::AllocaInst* storage = entry.CreateAlloca(llvm::ArrayType::get(Builder->getInt64Ty(), node->array.size),
+               nullptr, std::string(symbol_name(node->array.title)) + ".vector");
+            storage->setAlignment(llvm::Align(VectorAlignment));
+            declare_local(node->array.title, entry.CreatePtrToInt(storage, Builder->getInt64Ty()));
             break;
          }
-      case ASTNode::_WHILE_LOOP:
-         { 
-            llvm::BasicBlock *Then = llvm::BasicBlock::Create(*TheContext, "while_then", Builder->GetInsertBlock()->getParent());
-            llvm::BasicBlock *Merge = llvm::BasicBlock::Create(*TheContext, "while_merge", Builder->GetInsertBlock()->getParent());
+      case _ASSIGNMENT:
+         {
+            write_variable(node->assign.title, add_expression(node->assign.value));
+            break;
+         }
+      case _ARRAY_ASSIGNMENT:
+         {
+            llvm::Value* value = add_expression(node->factors.right);
+            Builder->CreateStore(value, element_address(node->factors.left));
+            break;
+         }
+      case _WHILE_LOOP:
+         {
+            // header: the condition, evaluated once per iteration
+            // body:   the statements, falling through to
+            // latch:  the loop's single back edge, carrying its llvm.loop metadata
+            // exit:   where the loop leaves
+            llvm::Function* function = Builder->GetInsertBlock()->getParent();
+            llvm::BasicBlock* header = llvm::BasicBlock::Create(*TheContext, "while_header", function);
+            llvm::BasicBlock* body = llvm::BasicBlock::Create(*TheContext, "while_body", function);
+            llvm::BasicBlock* exit = llvm::BasicBlock::Create(*TheContext, "while_exit", function);
 
+            Builder->CreateBr(header);
+            Builder->SetInsertPoint(header);
+            uint32_t site = profile_site('w');
             llvm::Value* cond_i1 = Builder->CreateICmpNE(
-               add_expression(node->list.inner), 
+               add_expression(node->loop.cond), 
                llvm::ConstantInt::get(*TheContext, llvm::APInt(64, 0)), 
-               "while_cond_i1_1" 
+               "while_cond_i1" 
             );
-            Builder->CreateCondBr(cond_i1, Then, Merge);
+            conditional_branch(cond_i1, body, exit, site);
+            seal_block(body);
+            seal_block(exit);
 
-            Builder->SetInsertPoint(Then);
-            add_statement(node->list.next);
-            cond_i1 = Builder->CreateICmpNE(
-               add_expression(node->list.inner), 
-               llvm::ConstantInt::get(*TheContext, llvm::APInt(64, 0)), 
-               "while_cond_i1_2" 
-            );
-            Builder->CreateCondBr(cond_i1, Then, Merge);
+            Builder->SetInsertPoint(body);
+            add_statements(node->loop.statements);
+            if (!Builder->GetInsertBlock()->getTerminator()) {
+               llvm::BasicBlock* latch = llvm::BasicBlock::Create(*TheContext, "while_latch", function, exit);
+               Builder->CreateBr(latch);
+               seal_block(latch);
+               Builder->SetInsertPoint(latch);
+               Builder->CreateBr(header)->setMetadata(llvm::LLVMContext::MD_loop, loop_metadata());
+            }
+            seal_block(header);
 
-            Builder->SetInsertPoint(Merge);
-            add_statement(node->successor);
+            Builder->SetInsertPoint(exit);
             break;
          }
-      case ASTNode::_IF:
+      case _IF:
          {
 
             llvm::BasicBlock *Then = llvm::BasicBlock::Create(*TheContext, "if_then", Builder->GetInsertBlock()->getParent());
             llvm::BasicBlock *Merge = llvm::BasicBlock::Create(*TheContext, "if_merge", Builder->GetInsertBlock()->getParent());
 
             // To set the i64 conditional (if_t.cond) to i1, we perform if_t.cond != 0.
+            uint32_t site = profile_site('i');
             llvm::Value* cond_i1 = Builder->CreateICmpNE(
                add_expression(node->if_t.cond), 
                llvm::ConstantInt::get(*TheContext, llvm::APInt(64, 0)), 
@@ -221,63 +775,79 @@ GCC_HOT static void add_statement(ASTNode* node) {
             );
             
             // Test if statement includes an "else" section
-            if (node->if_t.else_t->type != ASTNode::STOP) {
+            if (ast_list_length(node->if_t.else_t) != 0) {
                llvm::BasicBlock *Else = llvm::BasicBlock::Create(*TheContext, "if_else", Builder->GetInsertBlock()->getParent());
 
-               Builder->CreateCondBr(cond_i1, Then, Else);
+               conditional_branch(cond_i1, Then, Else, site);
+               seal_block(Else);
 
                // Write "else" code
                Builder->SetInsertPoint(Else);
-               add_statement(node->if_t.else_t);
-               if (!Else->getTerminator()) Builder->CreateBr(Merge);
+               add_statements(node->if_t.else_t);
+               if (!Builder->GetInsertBlock()->getTerminator()) Builder->CreateBr(Merge);
             
             }
             else {
-               Builder->CreateCondBr(cond_i1, Then, Merge);
+               conditional_branch(cond_i1, Then, Merge, site);
             }
 
             // Write "then" code.
+            seal_block(Then);
             Builder->SetInsertPoint(Then);
-            add_statement(node->if_t.statements);
-            if (!Then->getTerminator()) Builder->CreateBr(Merge);
+            add_statements(node->if_t.statements);
+            if (!Builder->GetInsertBlock()->getTerminator()) Builder->CreateBr(Merge);
+            seal_block(Merge);
 
             Builder->SetInsertPoint(Merge);
-            add_statement(node->successor);
-
             break;
          }
-      case ASTNode::_LABEL:
-         BasicBlockValues[node->string] = llvm::BasicBlock::Create(*TheContext, node->string, Builder->GetInsertBlock()->getParent());
-         Builder->CreateBr(BasicBlockValues[node->string]);
-         Builder->SetInsertPoint(BasicBlockValues[node->string]);
-         add_statement(node->successor);
-         break;
-      case ASTNode::_GOTO:
-         Builder->CreateBr(BasicBlockValues[node->string]);
-         add_statement(node->successor);
+      case _LABEL:
+         {
+            llvm::BasicBlock* label = label_block(node->symbol);
+            if (!Builder->GetInsertBlock()->getTerminator()) Builder->CreateBr(label);
+            Builder->SetInsertPoint(label);
+            break;
+         }
+      case _GOTO:
+         Builder->CreateBr(label_block(node->symbol));
          break;
-      case ASTNode::_RETURN:
-         Builder->CreateRet(add_expression(node->list.next));
-         functionDoesReturn = true;
+      case _RETURN:
+         {
+            if (ast_node(node->inner)->type != _FUNCTION_CALL) {
+               Builder->CreateRet(add_expression(node->inner));
+               break;
+            }
+
+            // A function returning a call to itself reuses its own frame, so
+            // recursive algorithms run in constant stack space even at -O0.
+            llvm::CallInst* call = add_call(node->inner);
+            llvm::Function* self = Builder->GetInsertBlock()->getParent();
+            if (call->getCalledOperand() == self && call->getFunctionType() == self->getFunctionType()) {
+               call->setTailCallKind(llvm::CallInst::TCK_MustTail);
+               SelfTailCalls.push_back(call);
+            }
+            Builder->CreateRet(call);
+            break;
+         }
+      case _FUNCTION_CALL:
+         add_call(index);
          break;
-      case ASTNode::_INC:
+      case _INC:
          {
             llvm::Value* inc = Builder->CreateAdd(
-               value_of(NamedValues[node->string]), 
+               read_variable(node->symbol), 
                llvm::ConstantInt::get(*TheContext, llvm::APInt(64, 1)), 
                "inctmp");
-            Builder->CreateStore(inc, NamedValues[node->string]);
-            add_statement(node->successor);
+            write_variable(node->symbol, inc);
             break;
          }
-      case ASTNode::_DEC:
+      case _DEC:
          {
             llvm::Value* dec = Builder->CreateSub(
-               value_of(NamedValues[node->string]), 
+               read_variable(node->symbol), 
                llvm::ConstantInt::get(*TheContext, llvm::APInt(64, 1)), 
                "dectmp");
-            Builder->CreateStore(dec, NamedValues[node->string]);
-            add_statement(node->successor);
+            write_variable(node->symbol, dec);
             break;
          }
       default:
@@ -286,84 +856,214 @@ GCC_HOT static void add_statement(ASTNode* node) {
    }
 }
 
+static void add_statements(ASTList list) {
+   const ASTIndex* items = ast_list_items(list);
+   for (uint32_t i = 0; i < ast_list_length(list); i++) {
+      // Code following a return or goto is only reachable through a label, but
+      // it still needs a block of its own to live in.
+      if (Builder->GetInsertBlock()->getTerminator() && ast_node(items[i])->type != _LABEL) {
+         Builder->SetInsertPoint(llvm::BasicBlock::Create(*TheContext, "unreachable", Builder->GetInsertBlock()->getParent()));
+         seal_block(Builder->GetInsertBlock());
+      }
+      add_statement(items[i]);
+   }
+}
 
 
-static void add_function(ASTNode* node) {
 
+static void add_function(ASTIndex index) {
+   ASTNode* node = ast_node(index);
+   timing_begin("IRGen Function", symbol_name(node->function.title));
 
-   // Create an array of Int64Ty's. Does not store their information.
-   std::vector<llvm::Type*> list;
-   for ( ASTNode* currentArg = node->function.args; 
-         currentArg; 
-         currentArg = currentArg->list.next
-   ) list.push_back(llvm::Type::getInt64Ty(*TheContext));
+   llvm::Function* function = define_function(node->function.title, ast_list_length(node->function.args));
 
-   // Create the function type, including arguments if any.
-   llvm::FunctionType *funcType;
-   if (list.size() == 0 ) 
-      funcType = llvm::FunctionType::get(
-         llvm::Type::getInt64Ty(*TheContext),
-         false
-      );
-   else 
-      funcType = llvm::FunctionType::get(
-         llvm::Type::getInt64Ty(*TheContext),
-         list,
-         false
-      );
+   // Forget the previous function's locals and labels.
+   NamedValues.reset();
+   SSAValues.reset();
+   BasicBlockValues.reset();
 
-   llvm::Function *function = llvm::Function::Create(
-      funcType,
-      llvm::Function::ExternalLinkage,
-      llvm::Twine(node->function.title),
-      *TheModule
-   );
+   Builder->SetInsertPoint(llvm::BasicBlock::Create(*TheContext, "entry", function));
+   AllocaPoint = llvm::CastInst::Create(llvm::Instruction::BitCast,
+      llvm::UndefValue::get(Builder->getInt64Ty()), Builder->getInt64Ty(), "allocapt");
+   Builder->Insert(AllocaPoint);
+   seal_block(Builder->GetInsertBlock());
 
-   functionDoesReturn = false; // False, unless proven otherwise.
+   // Parameters are locals like autos, so they can be assigned to.
+   const ASTIndex* params = ast_list_items(node->function.args);
+   for (uint32_t i = 0; i < ast_list_length(node->function.args); i++) {
+      if (ast_node(params[i])->type != _VARIABLE)
+         fatal_error("parameter \"%s\" cannot be a vector", symbol_name(ast_node(params[i])->array.title));
+      Symbol name = ast_node(params[i])->symbol;
+      llvm::Argument* arg = function->getArg(i);
+      arg->setName(symbol_name(name));
+      declare_local(name, arg);
+   }
 
-   Builder->SetInsertPoint(llvm::BasicBlock::Create(*TheContext, "entry", function));
+   profile_function_begin();
 
-   add_statement(node->function.statements); // Begin adding statements to module.
+   add_statements(node->function.statements); // Begin adding statements to module.
 
-   // If no return statement is made, then return undefined information.
-   if (!functionDoesReturn)
+   // If control can fall off the end, then return undefined information.
+   if (!Builder->GetInsertBlock()->getTerminator())
       Builder->CreateRet(llvm::UndefValue::get(Builder->getInt64Ty()));
+
+   // Labels may gain predecessors up to the last goto, so they are sealed only now.
+   if (ctx.ssa) {
+      for (llvm::BasicBlock& block : *function)
+         if (!SealedBlocks.count(&block)) seal_block(&block);
+      CurrentDefs.clear();
+      IncompletePhis.clear();
+      SealedBlocks.clear();
+   }
+   AllocaPoint->eraseFromParent();
+   AllocaPoint = nullptr;
+
+   // The callee may be handed a pointer into this frame, so it has to stay.
+   if (!SelfTailCalls.empty() && frame_escapes(function))
+      for (llvm::CallInst* call : SelfTailCalls) call->setTailCallKind(llvm::CallInst::TCK_None);
+   SelfTailCalls.clear();
+
+   profile_function_end(function);
+
+   if (ctx.verify && llvm::verifyFunction(*function, &llvm::errs()))
+      fatal_error("invalid IR generated for \"%s\"", symbol_name(node->function.title));
+   timing_end();
+}
+
+// A name among the initial values stands for its address.
+static llvm::Constant* initial_value(ASTIndex index) {
+   ASTNode* node = ast_node(index);
+   if (node->type == _NUMBER) return Builder->getInt64(node->integer);
+
+   return llvm::ConstantExpr::getPtrToInt(global_variable(node->symbol), Builder->getInt64Ty());
 }
 
-static void add_global_variable(ASTNode* node) {
-   // TODO
+// Words past the initial values are zero; an all-zero array becomes a zeroinitializer, so it lands in .bss.
+static llvm::Constant* initial_words(ASTList values, uint64_t length) {
+   std::vector<llvm::Constant*> words(length, Builder->getInt64(0));
+   const ASTIndex* items = ast_list_items(values);
+   for (uint32_t i = 0; i < ast_list_length(values); i++)
+      words[i] = initial_value(items[i]);
+   return llvm::ConstantArray::get(llvm::ArrayType::get(Builder->getInt64Ty(), length), words);
 }
 
-static void analyze_ast() {
+/**
+ * An external with several initial values is an array of words, read
+ * through its first. A vector's name is a word of its own holding the
+ * address of the storage, as in B, so other units may use it through a
+ * plain extrn; the storage is a separate array aligned for vector loads.
+ * Once the module is the whole program, internalize_program() makes the
+ * name constant and the optimizer sees straight through to the storage.
+ */
+static void add_global_variable(ASTIndex index) {
+   ASTNode* node = ast_node(index);
+   Symbol name = node->global.title;
+   uint32_t count = ast_list_length(node->global.values);
 
-   bool foundMainFunction = false;
-   
-   for (int i = 0; i < ast_length; i++)
-      if (generated_ast[i]->type == ASTNode::_FUNCTION)
-         if (strcmp(generated_ast[i]->function.title, "main") == 0)
-            foundMainFunction = true;
+   llvm::Constant* initializer;
+   if (node->global.size >= 0) {
+      uint64_t length = std::max<uint64_t>(node->global.size, count);
+      llvm::Constant* words = initial_words(node->global.values, length);
+      auto* storage = new llvm::GlobalVariable(*TheModule, words->getType(), false,
+         llvm::GlobalValue::InternalLinkage, words, std::string(symbol_name(name)) + ".vector");
+      storage->setAlignment(llvm::Align(VectorAlignment));
+      initializer = llvm::ConstantExpr::getPtrToInt(storage, Builder->getInt64Ty());
+   } else if (count > 1) {
+      initializer = initial_words(node->global.values, count);
+   } else {
+      initializer = count ? initial_value(ast_list_items(node->global.values)[0]) : Builder->getInt64(0);
+   }
 
-   if (!foundMainFunction) fatal_error("no entry point.");
+   // An extrn or an initial value may have declared the name already.
+   llvm::GlobalVariable* previous = GlobalValues.lookup(name);
+   if (previous && previous->hasInitializer())
+      fatal_error("external \"%s\" is defined twice", symbol_name(name));
 
+   auto* global = new llvm::GlobalVariable(*TheModule, initializer->getType(), false,
+      llvm::GlobalValue::ExternalLinkage, initializer, "");
+   global->setAlignment(llvm::Align(8));
+   if (previous) {
+      previous->replaceAllUsesWith(global);
+      global->takeName(previous);
+      previous->eraseFromParent();
+   } else {
+      global->setName(symbol_name(name));
+   }
+   GlobalValues.set(name, global);
 }
 
-extern "C" void generate_llvm_ir() {
+extern "C" void verify_entry_point() {
+   llvm::Function* entry = TheModule->getFunction("main");
+   if (!entry || entry->isDeclaration()) fatal_error("no entry point.");
+}
 
-   analyze_ast();
+extern "C" void begin_llvm_ir() {
+   GlobalValues.reset();
+   FunctionValues.reset();
+   profile_module_begin();
+}
 
-   for (int i = 0; i < ast_length; i++) {
-      switch (generated_ast[i]->type) {
-         case ASTNode::_FUNCTION:
-            add_function(generated_ast[i]);
-            break;
-         case ASTNode::_GLOBAL_DECLARATION:
-            add_global_variable(generated_ast[i]);
-            break;
-         default:
-            fatal_error("unrecognized root type \"%s\"\n", ASTNodeTypeNames[generated_ast[i]->type]);
+/**
+ * Generates one function or external as soon as the parser has it. Nothing
+ * refers back to its tree afterwards, so the caller may release it.
+ */
+extern "C" void generate_llvm_ir(ASTIndex definition) {
+   switch (ast_node(definition)->type) {
+      case _FUNCTION:
+         add_function(definition);
+         break;
+      case _GLOBAL_DECLARATION:
+         add_global_variable(definition);
+         break;
+      default:
+         fatal_error("unrecognized root type \"%s\"\n", ASTNodeTypeNames[ast_node(definition)->type]);
+         break;
+   }
+}
+
+extern "C" void finish_llvm_ir() {
+   profile_module_end();
+}
+
+/**
+ * When TheModule is the whole program, nothing outside it calls anything
+ * but main(). The rest becomes internal, so the optimizer may inline or
+ * drop it, and moves to the fast calling convention wherever every use is
+ * a direct call with the function's own prototype. Externals are only
+ * reachable from the module too, so one that is only ever loaded from is
+ * a constant, and goes to read-only data.
+ */
+extern "C" void internalize_program() {
+   for (llvm::Function& function : *TheModule) {
+      if (function.isDeclaration() || function.getName() == "main") continue;
+      function.setLinkage(llvm::GlobalValue::InternalLinkage);
+
+      bool direct = true;
+      for (llvm::Use& use : function.uses()) {
+         auto* call = llvm::dyn_cast<llvm::CallInst>(use.getUser());
+         if (!call || !call->isCallee(&use) || call->getFunctionType() != function.getFunctionType()) {
+            direct = false;
             break;
+         }
       }
+      if (!direct) continue;
 
+      function.setCallingConv(llvm::CallingConv::Fast);
+      for (llvm::User* user : function.users())
+         llvm::cast<llvm::CallInst>(user)->setCallingConv(llvm::CallingConv::Fast);
    }
 
-}
+   for (llvm::GlobalVariable& global : TheModule->globals()) {
+      if (global.isDeclaration() || !global.hasExternalLinkage()) continue;
+      global.setLinkage(llvm::GlobalValue::InternalLinkage);
+
+      bool stored = false;
+      for (llvm::User* user : global.users()) {
+         if (!llvm::isa<llvm::LoadInst>(user)) {
+            stored = true;
+            break;
+         }
+      }
+      if (!stored) global.setConstant(true);
+   }
+}
\ No newline at end of file
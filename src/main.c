@@ -23,60 +23,334 @@
 #include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
+#include <time.h>
+
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
 
 #include "llvm.h"
+#include "timing.h"
+#include "cache.h"
+#include "link.h"
 #include "context.h"
 #include "error.h"
 #include "ast.h"
+#include "simplify.h"
 #include "opt.h"
 
 extern int yyparse(void);                       // declare Bison parser function
-extern int yy_scan_string(const char *str);     // lex the file for keywords
+extern void* yy_scan_buffer(char *base, size_t size);   // lex a buffer in place
+extern FILE* yyin;                              // stream the lexer reads when no buffer is set
+extern double lex_seconds;                      // -ftime-report: time in the scanner, and its tokens
+extern unsigned lex_tokens;
 void parse_arguments(int argc, char **argv);    // parse the arguments provided to BLang
-char* read_file(const char *filename);          // Read an input file into a char*.
+void open_source(const char *filename);         // Map or stream an input file for the lexer.
+void release_source();
+void compile_unit(char *filename);              // Source to an optimized module in TheModule.
+void compile_units();                           // Every input as its own unit, linked in order.
+bool link_units();                              // -flto: units as bitcode straight to the linker
+bool whole_program();                           // TheModule is everything the executable runs
+char **build_units();
+void release_units(char **units);
+void run_arguments(int argc, char **argv);      // argv of the program under -run
+size_t count_lines(const char *text, size_t length);
+void print_throughput(const char *name);        // -v: source lines per second of this process
 void print_help();
 
 CompilerContext ctx = (CompilerContext){
    .emitAssembly = false,
    .emitLLVM = false,
+   .emitBC = false,
+   .compileOnly = false,
    .dumpAST = false,
+   .verbose = false,
+   .run = false,
    .outputFilename = "a.out",
    .optimization = 0,
+   .unrollLoops = -1,
+   .vectorize = -1,
+   .ssa = false,
+   .globalISel = false,
+   .verify = false,
+   .jobs = 0,
+   .parallelCodegen = 0,
+   .timeTrace = false,
+   .timeTraceGranularity = 500,
+   .timeReport = false,
+   .cacheDir = NULL,
+   .cacheSize = 1024,
+   .staticLink = false,
+   .functionSections = false,
+   .dataSections = false,
+   .gcSections = false,
+   .lto = 0,
+   .profileGenerate = NULL,
+   .profileUse = NULL,
 };
 
+static struct timespec started;                 // when this process began compiling
+
 int main(int argc, char *argv[]) {
+   timespec_get(&started, TIME_UTC);
    parse_arguments(argc, argv);
+   timing_initialize();
 
-   yy_scan_string(ctx.sourceText);           // Feed input
-   yyparse();                                // Start parsing
-
-   if (ctx.dumpAST) print_ast();
+   if (cache_restore()) {                    // Unchanged source: skip the whole build
+      timing_finish(ctx.outputFilename);
+      return 0;
+   }
 
-   initialize_llvm();
+   if (ctx.inputCount == 1)
+      compile_unit(ctx.inputFiles[0]);
+   else if (link_units()) {                  // -flto: the linker takes it from here
+      timing_finish(ctx.outputFilename);
+      return 0;
+   }
+   else
+      compile_units();
 
-   generate_llvm_ir();
+   // Objects, assembly and bitcode may be libraries; only a program needs main().
+   if (ctx.run || (!ctx.compileOnly && !ctx.emitAssembly && !ctx.emitBC && !ctx.emitLLVM))
+      verify_entry_point();
 
-   optimize();
+   if (ctx.run) {
+      timing_begin("Run", ctx.programArgs[0]);
+      int status = run_jit(ctx.programArgCount, ctx.programArgs);
+      timing_end();
+      timing_finish(ctx.outputFilename);
+      return status;
+   }
 
+   timing_begin("Emit", ctx.outputFilename);
    if (ctx.emitLLVM) 
       export_ir();
    else if (ctx.emitAssembly) 
       export_asm();
+   else if (ctx.emitBC)
+      export_bc(ctx.outputFilename);
    else 
       export_bin();
-   
+   timing_end();
+
+   cache_store();
+   if (ctx.verbose && ctx.inputCount == 1) print_throughput(ctx.outputFilename);
+
+   timing_finish(ctx.outputFilename);
    return 0;
 }
 
 
+/*
+ * Called by the parser with each function and external as soon as it is
+ * complete, while the rest of the file is still to be read. Its tree is
+ * recycled once the module has it, so memory follows the largest
+ * definition rather than the whole file.
+ */
+static double definition_seconds = 0;          // in compile_definition(), out of the parse
+
+void compile_definition(ASTIndex definition) {
+   double start = timing_now();
+   timing_begin("Simplify", NULL);
+   simplify_ast(definition);
+   timing_end();
+
+   if (ctx.dumpAST) print_ast(definition);
+
+   timing_begin("Generate IR", NULL);
+   generate_llvm_ir(definition);
+   timing_end();
+
+   ast_recycle();
+   definition_seconds += timing_now() - start;
+}
+
+void compile_unit(char *filename) {
+   ctx.inputFile = filename;
+
+   initialize_llvm();
+   begin_llvm_ir();
+
+   // Parsing drives simplification and IR generation, one definition at a time.
+   timing_begin("Front End", filename);
+   open_source(filename);
+   if (ctx.sourceText)
+      yy_scan_buffer(ctx.sourceText, ctx.sourceLength + 2);  // Lex the mapping in place
+   lex_seconds = definition_seconds = 0;
+   lex_tokens = 0;
+   double start = timing_now();
+   if (yyparse() != 0)                       // Start parsing
+      fatal_error("failed to parse \"%s\"", filename);
+   // Scanning and parsing interleave token by token, so they are summed rather than scoped.
+   timing_record("Lex", lex_seconds, lex_tokens);
+   timing_record("Parse", timing_now() - start - lex_seconds - definition_seconds, 1);
+   if (ctx.verbose && ctx.sourceText)           // streamed input is counted as it is read
+      ctx.sourceLines += count_lines(ctx.sourceText, ctx.sourceLength);
+   release_source();                         // Identifiers were copied out by the lexer
+   timing_end();
+
+   finish_llvm_ir();
+   if (ctx.dumpAST) printf("\n");
+
+   if (ctx.verbose) {
+      print_simplify_stats();
+      print_ast_stats();
+   }
+   ast_release();
+
+   if (whole_program()) internalize_program();
+
+   timing_begin("Optimize", filename);
+   optimize();
+   timing_end();
+}
+
+// One source file built straight to an executable (or run): only main() is entered from outside.
+bool whole_program() {
+   return ctx.inputCount == 1 && !ctx.compileOnly && !ctx.emitBC && !ctx.emitLLVM && !ctx.emitAssembly && !ctx.lto;
+}
+
+/**
+ * Compiles every input file as a separate translation unit, each in a worker
+ * process of its own with a private LLVMContext and Module. The lexer, the
+ * parser and the AST are global state, so processes rather than threads give
+ * each unit its own copy of them. Workers hand back optimized bitcode, which
+ * is linked into TheModule in command-line order, so the result does not
+ * depend on which worker finishes first.
+ */
+void compile_units() {
+   char **units = build_units();
+
+   ctx.inputFile = ctx.outputFilename;
+   initialize_llvm();
+   timing_begin("Link", NULL);
+   for (int i = 0; i < ctx.inputCount; i++)
+      link_bc(units[i]);
+   timing_end();
+
+   release_units(units);
+}
+
+/**
+ * With -flto (and an executable to produce) the units are not merged here:
+ * their bitcode goes to the linker, which optimizes across them and, for
+ * ThinLTO, runs the backends in parallel.
+ */
+bool link_units() {
+   if (!ctx.lto || ctx.compileOnly || ctx.emitBC || ctx.emitLLVM || ctx.emitAssembly || ctx.run)
+      return false;
+
+   char **units = build_units();
+
+   ctx.inputFile = ctx.outputFilename;
+   initialize_llvm();                        // in-process lld generates code for these targets
+   timing_begin("Link", NULL);
+   link_executable((const char**)units, ctx.inputCount, ctx.outputFilename);
+   timing_end();
+
+   release_units(units);
+   return true;
+}
+
+// Compile every input to bitcode in worker processes, see compile_units().
+char **build_units() {
+   char **units = malloc(sizeof(char*) * ctx.inputCount);
+   if (!units) fatal_error("failed to allocate memory for %d inputs", ctx.inputCount);
+   for (int i = 0; i < ctx.inputCount; i++)
+      units[i] = temporary_file("bc");
+
+   int failures = 0;
+
+#if defined(_WIN32)
+   for (int i = 0; i < ctx.inputCount; i++) {
+      compile_unit(ctx.inputFiles[i]);
+      export_bc(units[i]);
+   }
+#else
+   // Worker traces go to temporary files, merged into the one next to the output.
+   char **traces = NULL;
+   if (ctx.timeTrace) {
+      traces = malloc(sizeof(char*) * ctx.inputCount);
+      if (!traces) fatal_error("failed to allocate memory for %d inputs", ctx.inputCount);
+      for (int i = 0; i < ctx.inputCount; i++)
+         traces[i] = temporary_file("json");
+   }
+
+   int jobs = ctx.jobs > 0 ? ctx.jobs : (int)sysconf(_SC_NPROCESSORS_ONLN);
+   if (jobs < 1) jobs = 1;
+
+   int running = 0;
+   for (int next = 0; next < ctx.inputCount || running > 0; ) {
+      if (next < ctx.inputCount && running < jobs) {
+         fflush(stdout);
+         fflush(stderr);
+         pid_t pid = fork();
+         if (pid < 0) fatal_error("failed to start a worker for \"%s\"", ctx.inputFiles[next]);
+         if (pid == 0) {
+            timespec_get(&started, TIME_UTC);
+            compile_unit(ctx.inputFiles[next]);
+            export_bc(units[next]);
+            if (ctx.verbose) print_throughput(ctx.inputFiles[next]);
+            timing_finish(traces ? traces[next] : ctx.outputFilename);
+            fflush(stdout);
+            _exit(EXIT_SUCCESS);
+         }
+         running++;
+         next++;
+         continue;
+      }
+
+      int status;
+      if (wait(&status) < 0) break;
+      running--;
+      if (!WIFEXITED(status) || WEXITSTATUS(status) != EXIT_SUCCESS) failures++;
+   }
+
+   if (traces) {
+      for (int i = 0; i < ctx.inputCount; i++) {
+         timing_merge(traces[i], ctx.inputFiles[i]);
+         free(traces[i]);
+      }
+      free(traces);
+   }
+#endif
+
+   if (failures) {
+      release_units(units);
+      fatal_error("%d of %d input files failed to compile", failures, ctx.inputCount);
+   }
+   return units;
+}
+
+void release_units(char **units) {
+   for (int i = 0; i < ctx.inputCount; i++) {
+      remove(units[i]);
+      free(units[i]);
+   }
+   free(units);
+}
+
 void parse_arguments(int argc, char *argv[]) {
    if (argc == 1)
       print_help();
 
+   ctx.inputFiles = malloc(sizeof(char*) * argc);
+   if (!ctx.inputFiles) fatal_error("failed to allocate memory for the argument list");
+
+   int pic = -1;                             // -fpic/-fno-pic, else decided by -static
+
    for (int i = 1; i < argc; ++i) {
       if (strcmp(argv[i], "-S") == 0) { ctx.emitAssembly = true; }
       else if (strcmp(argv[i], "-emit-llvm") == 0) { ctx.emitLLVM = true; }
+      else if (strcmp(argv[i], "-emit-bc") == 0) { ctx.emitBC = true; }
+      else if (strcmp(argv[i], "-c") == 0) { ctx.compileOnly = true; }
       else if (strcmp(argv[i], "-ast-dump") == 0) { ctx.dumpAST = true; }
+      else if (strcmp(argv[i], "-v") == 0) { ctx.verbose = true; }
+      else if (strcmp(argv[i], "-run") == 0) { ctx.run = true; }
       
       else if (strcmp(argv[i], "-h") == 0 || strcmp(argv[i], "--help") == 0) { print_help(); }
 
@@ -85,6 +359,67 @@ void parse_arguments(int argc, char *argv[]) {
          i++;
       }
 
+      else if (strcmp(argv[i], "-") == 0) {
+         ctx.inputFiles[ctx.inputCount++] = argv[i];
+         if (ctx.run) { run_arguments(argc - i, argv + i); break; }
+      }
+
+      else if (strcmp(argv[i], "-j") == 0) {
+         if (i + 1 >= argc) fatal_error("missing job count after '-j'");
+         ctx.jobs = atoi(argv[i + 1]);
+         i++;
+      }
+      else if (strncmp(argv[i], "-j", 2) == 0) { ctx.jobs = atoi(argv[i] + 2); }
+
+      else if (strcmp(argv[i], "-fparallel-codegen") == 0) { ctx.parallelCodegen = -1; }
+      else if (strncmp(argv[i], "-fparallel-codegen=", 19) == 0) {
+         ctx.parallelCodegen = atoi(argv[i] + 19);
+         if (ctx.parallelCodegen < 1) fatal_error("invalid thread count in '%s'", argv[i]);
+      }
+
+      else if (strcmp(argv[i], "-funroll-loops") == 0) { ctx.unrollLoops = 1; }
+      else if (strcmp(argv[i], "-fno-unroll-loops") == 0) { ctx.unrollLoops = 0; }
+      else if (strcmp(argv[i], "-fvectorize") == 0) { ctx.vectorize = 1; }
+      else if (strcmp(argv[i], "-fno-vectorize") == 0) { ctx.vectorize = 0; }
+      else if (strcmp(argv[i], "-fssa") == 0) { ctx.ssa = true; }
+      else if (strcmp(argv[i], "-fglobal-isel") == 0) { ctx.globalISel = true; }
+      else if (strcmp(argv[i], "-verify") == 0) { ctx.verify = true; }
+
+      else if (strncmp(argv[i], "-march=", 7) == 0) { ctx.targetCPU = argv[i] + 7; }
+      else if (strncmp(argv[i], "-mcpu=", 6) == 0) { ctx.targetCPU = argv[i] + 6; }
+      else if (strncmp(argv[i], "-mattr=", 7) == 0) { ctx.targetFeatures = argv[i] + 7; }
+
+      else if (strcmp(argv[i], "-ftime-trace") == 0) { ctx.timeTrace = true; }
+      else if (strncmp(argv[i], "-ftime-trace-granularity=", 25) == 0) {
+         ctx.timeTraceGranularity = atoi(argv[i] + 25);
+         if (ctx.timeTraceGranularity < 0) fatal_error("invalid granularity in '%s'", argv[i]);
+      }
+      else if (strcmp(argv[i], "-ftime-report") == 0) { ctx.timeReport = true; }
+
+      else if (strcmp(argv[i], "-static") == 0) { ctx.staticLink = true; }
+      else if (strcmp(argv[i], "-fpic") == 0 || strcmp(argv[i], "-fpie") == 0
+         || strcmp(argv[i], "-fPIC") == 0 || strcmp(argv[i], "-fPIE") == 0) { pic = 1; }
+      else if (strcmp(argv[i], "-fno-pic") == 0 || strcmp(argv[i], "-fno-pie") == 0
+         || strcmp(argv[i], "-fno-PIC") == 0 || strcmp(argv[i], "-fno-PIE") == 0) { pic = 0; }
+      else if (strcmp(argv[i], "-ffunction-sections") == 0) { ctx.functionSections = true; }
+      else if (strcmp(argv[i], "-fdata-sections") == 0) { ctx.dataSections = true; }
+      else if (strcmp(argv[i], "--gc-sections") == 0 || strcmp(argv[i], "-Wl,--gc-sections") == 0) { ctx.gcSections = true; }
+
+      else if (strcmp(argv[i], "-flto") == 0 || strcmp(argv[i], "-flto=full") == 0) { ctx.lto = 1; }
+      else if (strcmp(argv[i], "-flto=thin") == 0) { ctx.lto = 2; }
+      else if (strcmp(argv[i], "-fno-lto") == 0) { ctx.lto = 0; }
+
+      else if (strcmp(argv[i], "-fprofile-generate") == 0) { ctx.profileGenerate = "default.profraw"; }
+      else if (strncmp(argv[i], "-fprofile-generate=", 19) == 0) { ctx.profileGenerate = argv[i] + 19; }
+      else if (strcmp(argv[i], "-fprofile-use") == 0) { ctx.profileUse = "default.profdata"; }
+      else if (strncmp(argv[i], "-fprofile-use=", 14) == 0) { ctx.profileUse = argv[i] + 14; }
+
+      else if (strncmp(argv[i], "-fcache-dir=", 12) == 0) { ctx.cacheDir = argv[i] + 12; }
+      else if (strncmp(argv[i], "-fcache-size=", 13) == 0) {
+         ctx.cacheSize = atol(argv[i] + 13);
+         if (ctx.cacheSize < 1) fatal_error("invalid cache size in '%s'", argv[i]);
+      }
+
       else if (strcmp(argv[i], "-O0") == 0)
          ctx.optimization = 0;
       else if (strcmp(argv[i], "-O1") == 0)
@@ -101,14 +436,41 @@ void parse_arguments(int argc, char *argv[]) {
       else { 
          if (argv[i][0] == '-') { fatal_error("unknown argument: \'%s\'", argv[i]); }
          else { 
-            ctx.inputFile = argv[i];
-            ctx.sourceText = read_file(argv[i]); 
+            ctx.inputFiles[ctx.inputCount++] = argv[i];
+            if (ctx.run) { run_arguments(argc - i, argv + i); break; }
          }
       }
    }
+
+   if (ctx.inputCount == 0) fatal_error("no input files");
+
+   // Executables are PIEs unless -static asks for a position dependent one.
+   ctx.pic = pic >= 0 ? pic : !ctx.staticLink;
+}
+
+// Under -run the source file and everything after it belong to the program.
+void run_arguments(int argc, char **argv) {
+   ctx.programArgs = argv;
+   ctx.programArgCount = argc;
 }
 
-char* read_file(const char *filename) {
+/**
+ * "-" and anything that is not a regular file (pipes, FIFOs) are streamed
+ * through the lexer's YY_INPUT in chunks and never held in memory as a whole.
+ *
+ * Regular files are mmap()ed and lexed in place. yy_scan_buffer() needs two
+ * NUL bytes after the text: the zero fill past the end of the file's last
+ * page provides them, and when the file ends too close to a page boundary
+ * they come from an anonymous page reserved behind the mapping. The mapping
+ * is private because flex briefly writes a NUL after every token.
+ */
+void open_source(const char *filename) {
+   if (strcmp(filename, "-") == 0) {
+      yyin = stdin;
+      return;
+   }
+
+#if defined(_WIN32)
    FILE *f = fopen(filename, "rb");
    if (!f) fatal_error("failed to open file \"%s\"", filename);
 
@@ -116,13 +478,66 @@ char* read_file(const char *filename) {
    long n = ftell(f);
    rewind(f);
 
-   char *buf = malloc(n + 1);
+   char *buf = calloc(n + 2, 1);
    if (!buf) fatal_error("failed to allocate memory for \"%s\"", filename);
 
    fread(buf, 1, n, f);
-   buf[n] = '\0';
    fclose(f);
-   return buf;
+   ctx.sourceText = buf;
+   ctx.sourceLength = n;
+#else
+   int fd = open(filename, O_RDONLY);
+   if (fd < 0) fatal_error("failed to open file \"%s\"", filename);
+
+   struct stat st;
+   if (fstat(fd, &st) != 0) fatal_error("failed to read file \"%s\"", filename);
+
+   if (!S_ISREG(st.st_mode)) {
+      yyin = fdopen(fd, "rb");
+      if (!yyin) fatal_error("failed to read file \"%s\"", filename);
+      return;
+   }
+
+   size_t length = (size_t)st.st_size;
+   size_t page = (size_t)sysconf(_SC_PAGESIZE);
+   size_t reserved = (length + 2 + page - 1) & ~(page - 1);
+
+   char *base = mmap(NULL, reserved, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+   if (base == MAP_FAILED) fatal_error("failed to map file \"%s\"", filename);
+
+   if (length && mmap(base, length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_FIXED, fd, 0) == MAP_FAILED)
+      fatal_error("failed to map file \"%s\"", filename);
+   close(fd);
+
+   ctx.sourceText = base;
+   ctx.sourceLength = length;
+#endif
+}
+
+void release_source() {
+   if (!ctx.sourceText) return;
+#if defined(_WIN32)
+   free(ctx.sourceText);
+#else
+   size_t page = (size_t)sysconf(_SC_PAGESIZE);
+   munmap(ctx.sourceText, (ctx.sourceLength + 2 + page - 1) & ~(page - 1));
+#endif
+   ctx.sourceText = NULL;
+}
+
+size_t count_lines(const char *text, size_t length) {
+   size_t lines = 0;
+   for (const char *end = text + length; (text = memchr(text, '\n', end - text)) != NULL; text++)
+      lines++;
+   return lines;
+}
+
+void print_throughput(const char *name) {
+   struct timespec now;
+   timespec_get(&now, TIME_UTC);
+   double seconds = (double)(now.tv_sec - started.tv_sec) + (now.tv_nsec - started.tv_nsec) / 1e9;
+   fprintf(stderr, "blang: %s: %zu lines in %.3fs, %.0f lines/s\n",
+      name, ctx.sourceLines, seconds, seconds > 0 ? ctx.sourceLines / seconds : 0.0);
 }
 
 void print_help() {
@@ -136,14 +551,46 @@ void print_help() {
       "  -h, --help            Show this help message and exit\n"
       // "  -v, --version         Show compiler version\n"
       "  -o <file>             Specify output file name (default: a.out)\n"
+      "  -run <file> [args]    JIT-compile and run the program, passing it args\n"
+      "  -                     Read the source from standard input\n"
+      "  -j <N>                Compile up to N files at once (default: one per core)\n"
+      "  -fparallel-codegen[=N] Optimize and emit the module as N partitions in parallel\n"
+      "  -c                    Compile to an object file, do not link\n"
       "  -S                    Compile to assembly code only\n"
       "  -emit-llvm           Emit LLVM IR instead of machine code\n"
+      "  -emit-bc              Emit LLVM bitcode instead of machine code\n"
+      "  -flto[=full|thin]     Optimize across files at link time; objects are bitcode\n"
+      "  -fprofile-generate[=<file>] Count branches and calls, written to <file> at exit\n"
+      "                        (default: default.profraw)\n"
+      "  -fprofile-use[=<file>] Optimize with counts merged by blang-profdata\n"
+      "                        (default: default.profdata)\n"
       "  -dump-ast            Output the abstract syntax tree (AST)\n"
+      "  -v                    Print compilation statistics to stderr\n"
       "  -O0, -O1, -O2, -O3    Optimization level (default: -O0)\n"
+      "  -funroll-loops, -fno-unroll-loops Unroll loops (default: at -O2 and above)\n"
+      "  -fvectorize, -fno-vectorize Vectorize loops (default: at -O2 and above, not -Oz)\n"
+      "  -fssa                 Keep autos in SSA registers rather than stack slots, even at -O0\n"
+      "  -fglobal-isel         Select instructions with GlobalISel (default: FastISel at -O0)\n"
+      "  -verify               Check the generated IR, and again after every pass\n"
+      "  -march=native         Generate code for the host CPU and its features\n"
+      "  -mcpu=<name>          Generate code for the named CPU\n"
+      "  -mattr=<+a,-b,...>    Enable or disable target features\n"
+      "  -static               Link a position dependent static executable\n"
+      "  -fpie, -fno-pie       Generate position independent code (default unless -static)\n"
+      "  -ffunction-sections   Place each function in its own section\n"
+      "  -fdata-sections       Place each global variable in its own section\n"
+      "  --gc-sections         Remove unreferenced sections when linking\n"
+      "  -ftime-trace          Write a Chrome trace of the compilation to <output>.json\n"
+      "  -ftime-trace-granularity=<us> Drop trace events shorter than this (default: 500)\n"
+      "  -ftime-report         Print the time spent in each phase to stderr\n"
+      "  -fcache-dir=<dir>     Reuse object and assembly output of unchanged sources\n"
+      "  -fcache-size=<MiB>    Evict least recently used cache entries past this size (default: 1024)\n"
       "\n"
       "Examples:\n"
       "  blang main.b            Compile and link main.b to a.out\n"
+      "  blang -c main.b         Compile main.b to an object file\n"
       "  blang -S main.b         Generate assembly code from main.b\n"
+      "  blang -run main.b x y   Run main.b in-process with arguments x and y\n"
       "  blang -O2 -o prog main.b  Compile main.b with optimization level 2 to prog\n"
     );
     exit(0);
@@ -23,27 +23,34 @@
 #include <stdio.h>
 #include "ast.h"
 #include "error.h"
-#include "opt.h"
 
 extern void yyerror(const char *s);
 extern int yylex(void);
 extern int yyparse(void);
 extern int yy_scan_string(const char *str);
 
-static void malloc_err() { fatal_error("failed to allocate space for an AST node."); }
+// The parser stacks live on the heap, so deeply nested expressions need not
+// stop at Bison's default of 10000 levels.
+#define YYMAXDEPTH 10000000
 %}
 
+%code requires {
+#include "ast.h"
+}
 
 %union {
    int      integer;
+   Symbol   symbol;
    char*    str;
    char     character;
 
-   struct ASTNode* node;
+   ASTIndex node;
+   ASTList  list;
+   uint32_t mark;
 }
 
 
-%token <str> IDENTIFIER
+%token <symbol> IDENTIFIER
 %token AUTO EXTRN
 %token <integer> NUMBER CHARACTER ARRAY
 %token <str> STRING
@@ -56,176 +63,153 @@ static void malloc_err() { fatal_error("failed to allocate space for an AST node
 
 
 %type <node> function 
-%type <node> statement_list statement 
-%type <node> expression declaration parameters
-%type <node> array_reference else block;
+%type <node> statement 
+%type <node> expression initializer declarator
+%type <list> declaration parameters initializers
+%type <list> array_reference else block
+%type <mark> statement_list declaration_list parameter_list initializer_list subscripts
 
+/*
+ * Lowest to highest, as in C. Without a level for the comparisons Bison
+ * shifted on every conflict, so "a + b < c" parsed as "a + (b < c)" and
+ * "-a <= b" as "-(a <= b)". Unary minus and ! bind tightest.
+ */
+%left EQ NEQ
+%left '<' '>' LTEQ GTEQ
 %left '+' '-'
 %left '*' '/'
+%right UNARY
 
 %%
 
 program:
    /* empty */ 
-   |  program IDENTIFIER expression ';' {
-      ASTNode* node = malloc(sizeof(ASTNode));
-      if (GCC_UNLIKELY(!node)) malloc_err();
-      node->type = _GLOBAL_DECLARATION;
-      node->list.title = $2;
-      node->list.next = $3;
-      append_statement(node);
-   }
-   |  program function { append_statement($2); }
+   |  program IDENTIFIER initializers ';' {
+      ASTIndex node = ast_new_node(_GLOBAL_DECLARATION);
+      ast_node(node)->global.title = $2;
+      ast_node(node)->global.size = -1;
+      ast_node(node)->global.values = $3;
+      compile_definition(node);
+   }
+   |  program IDENTIFIER '[' ']' initializers ';' {
+      ASTIndex node = ast_new_node(_GLOBAL_DECLARATION);
+      ast_node(node)->global.title = $2;
+      ast_node(node)->global.size = 0;
+      ast_node(node)->global.values = $5;
+      compile_definition(node);
+   }
+   |  program IDENTIFIER '[' NUMBER ']' initializers ';' {
+      ASTIndex node = ast_new_node(_GLOBAL_DECLARATION);
+      ast_node(node)->global.title = $2;
+      ast_node(node)->global.size = $4;
+      ast_node(node)->global.values = $6;
+      compile_definition(node);
+   }
+   |  program function { compile_definition($2); }
    ;
 
 function:
    IDENTIFIER '(' declaration ')' '{' statement_list '}' { 
-      ASTNode* node = malloc(sizeof(ASTNode));
-      if (GCC_UNLIKELY(!node)) malloc_err();
-      node->type = _FUNCTION;
-      node->function.title = $1;
-      node->function.args = $3;
-      node->function.statements = $6;
-      $$ = node;
+      ASTList statements = ast_list_end($6);
+      $$ = ast_new_node(_FUNCTION);
+      ast_node($$)->function.title = $1;
+      ast_node($$)->function.args = $3;
+      ast_node($$)->function.statements = statements;
    }
    ;
 
 
+/* Left-recursive, so statements are collected in order on the list stack. */
 statement_list:
-   /* empty */ {
-      ASTNode* node = malloc(sizeof(ASTNode));
-      if (GCC_UNLIKELY(!node)) malloc_err();
-      node->type = STOP;
-      $$ = node;
-   }
-   |  statement statement_list {
-      ASTNode* node = $1;
-      node->successor = $2;
-      $$ = node;
+   /* empty */ { $$ = ast_list_begin(); }
+   |  statement_list statement {
+      ast_list_push($2);
+      $$ = $1;
    }
    ;
 
 statement:
    AUTO declaration ';' { 
-      ASTNode* node = malloc(sizeof(ASTNode));
-      if (GCC_UNLIKELY(!node)) malloc_err();
-      node->type = _AUTO;
-      node->list.next = $2;
+      $$ = ast_new_node(_AUTO);
+      ast_node($$)->list.items = $2;
 
       // Set all variables defined to be of type "AUTO"
-      ASTNode* current = node;
-      while (current->type != STOP) {
-         current->list.variableType = VAR_AUTO;
-         current = current->list.next;
-      }
-
-      $$ = node;
+      const ASTIndex* items = ast_list_items($2);
+      for (uint32_t i = 0; i < ast_list_length($2); i++)
+         ast_node(items[i])->variableType = VAR_AUTO;
    }
    |  EXTRN declaration ';' { 
-      ASTNode* node = malloc(sizeof(ASTNode));
-      if (GCC_UNLIKELY(!node)) malloc_err();
-      node->type = _EXTRN;
-      node->list.next = $2;
+      $$ = ast_new_node(_EXTRN);
+      ast_node($$)->list.items = $2;
 
       // Set all variables defined to be of type "EXTRN"
-      ASTNode* current = node;
-      while (current->type != STOP) {
-         current->list.variableType = VAR_EXTRN;
-         current = current->list.next;
-      }
-
-      $$ = node;
+      const ASTIndex* items = ast_list_items($2);
+      for (uint32_t i = 0; i < ast_list_length($2); i++)
+         ast_node(items[i])->variableType = VAR_EXTRN;
    }
    |  IDENTIFIER '=' expression ';' { 
-      ASTNode* node = malloc(sizeof(ASTNode));
-      if (GCC_UNLIKELY(!node)) malloc_err();
-      node->type = _ASSIGNMENT;
-      node->list.title = $1;
-      node->list.next = $3;
-      $$ = node;
+      $$ = ast_new_node(_ASSIGNMENT);
+      ast_node($$)->assign.title = $1;
+      ast_node($$)->assign.value = $3;
+   }
+   |  IDENTIFIER array_reference '=' expression ';' {
+      ASTIndex element = ast_new_node(_ARRAY_REF);
+      ast_node(element)->list.title = $1;
+      ast_node(element)->list.items = $2;
+      $$ = ast_new_binary(_ARRAY_ASSIGNMENT, element, $4);
    }
 
    |  WHILE '(' expression ')' block { 
-      ASTNode* node = malloc(sizeof(ASTNode));
-      if (GCC_UNLIKELY(!node)) malloc_err();
-      node->type = _WHILE_LOOP;
-      node->list.inner = $3;
-      node->list.next = $5;
-      $$ = node;
+      $$ = ast_new_node(_WHILE_LOOP);
+      ast_node($$)->loop.cond = $3;
+      ast_node($$)->loop.statements = $5;
    }
    
    |  IF '(' expression ')' block else { 
-      ASTNode* node = malloc(sizeof(ASTNode));
-      if (GCC_UNLIKELY(!node)) malloc_err();
-      node->type = _IF;
-      node->if_t.cond = $3;
-      node->if_t.statements = $5;
-      node->if_t.else_t = $6;
-      $$ = node;
+      $$ = ast_new_node(_IF);
+      ast_node($$)->if_t.cond = $3;
+      ast_node($$)->if_t.statements = $5;
+      ast_node($$)->if_t.else_t = $6;
    }
 
    |  IDENTIFIER ':' { 
-      ASTNode* node = malloc(sizeof(ASTNode));
-      if (GCC_UNLIKELY(!node)) malloc_err();
-      node->type = _LABEL;
-      node->string = $1;
-      $$ = node;
+      $$ = ast_new_node(_LABEL);
+      ast_node($$)->symbol = $1;
    }
 
    |  IDENTIFIER '(' parameters ')' ';' { 
-      ASTNode* node = malloc(sizeof(ASTNode));
-      if (GCC_UNLIKELY(!node)) malloc_err();
-      node->type = _FUNCTION_CALL;
-      node->list.title = $1;
-      node->list.next = $3;
-      $$ = node;
+      $$ = ast_new_node(_FUNCTION_CALL);
+      ast_node($$)->list.title = $1;
+      ast_node($$)->list.items = $3;
    }
 
 
    |  IDENTIFIER INC ';' {
-      ASTNode* node = malloc(sizeof(ASTNode));
-      if (GCC_UNLIKELY(!node)) malloc_err();
-      node->type = _INC;
-      node->string = $1;
-      $$ = node;
+      $$ = ast_new_node(_INC);
+      ast_node($$)->symbol = $1;
    }
    |  INC IDENTIFIER ';' {
-      ASTNode* node = malloc(sizeof(ASTNode));
-      if (GCC_UNLIKELY(!node)) malloc_err();
-      node->type = _INC;
-      node->string = $2;
-      $$ = node;
+      $$ = ast_new_node(_INC);
+      ast_node($$)->symbol = $2;
    }
       
    |  IDENTIFIER DEC ';' {
-      ASTNode* node = malloc(sizeof(ASTNode));
-      if (GCC_UNLIKELY(!node)) malloc_err();
-      node->type = _DEC;
-      node->string = $1;
-      $$ = node;
+      $$ = ast_new_node(_DEC);
+      ast_node($$)->symbol = $1;
    }
    |  DEC IDENTIFIER ';' {
-      ASTNode* node = malloc(sizeof(ASTNode));
-      if (GCC_UNLIKELY(!node)) malloc_err();
-      node->type = _DEC;
-      node->string = $2;
-      $$ = node;
+      $$ = ast_new_node(_DEC);
+      ast_node($$)->symbol = $2;
    }
 
    |  RETURN '(' expression ')' ';' { 
-      ASTNode* node = malloc(sizeof(ASTNode));
-      if (GCC_UNLIKELY(!node)) malloc_err();
-      node->type = _RETURN;
-      node->list.next = $3;
-      $$ = node;
+      $$ = ast_new_node(_RETURN);
+      ast_node($$)->inner = $3;
    }
 
    | GOTO IDENTIFIER ';' {
-      ASTNode* node = malloc(sizeof(ASTNode));
-      if (GCC_UNLIKELY(!node)) malloc_err();
-      node->type = _GOTO;
-      node->string = $2;
-      $$ = node;
+      $$ = ast_new_node(_GOTO);
+      ast_node($$)->symbol = $2;
    }
    ;
 
@@ -233,289 +217,183 @@ expression:
 
    '(' expression ')' { $$ = $2; }
 
-   | '!' expression {
-      ASTNode* node = malloc(sizeof(ASTNode));
-      if (GCC_UNLIKELY(!node)) malloc_err();
-      node->type = _NOT;
-      node->inner = $2;
-      $$ = node;
-   }
-
-   | '-' expression {
-      ASTNode* node = malloc(sizeof(ASTNode));
-      if (GCC_UNLIKELY(!node)) malloc_err();
-      node->type = _MULTIPLY;
-      node->factors.left = $2;
-
-      ASTNode* negative = malloc(sizeof(ASTNode));
-      if (GCC_UNLIKELY(!negative)) malloc_err();
-      negative->type = _NUMBER;
-      negative->integer = -1; // Multiply by -1.
-
-      node->factors.right = negative;
-      $$ = node;
-   }
-
-   |  expression '+' expression {  
-      ASTNode* node = malloc(sizeof(ASTNode));
-      if (GCC_UNLIKELY(!node)) malloc_err();
-      node->type = _ADD;
-      node->factors.left = $1;
-      node->factors.right = $3;
-      $$ = node;
-   }
-
-   |  expression '-' expression {  
-      ASTNode* node = malloc(sizeof(ASTNode));
-      if (GCC_UNLIKELY(!node)) malloc_err();
-      node->type = _SUBTRACT;
-      node->factors.left = $1;
-      node->factors.right = $3;
-      $$ = node;
-   }
-
-   |  expression '*' expression {  
-      ASTNode* node = malloc(sizeof(ASTNode));
-      if (GCC_UNLIKELY(!node)) malloc_err();
-      node->type = _MULTIPLY;
-      node->factors.left = $1;
-      node->factors.right = $3;
-      $$ = node;
-   }
-
-   |  expression '/' expression {  
-      ASTNode* node = malloc(sizeof(ASTNode));
-      if (GCC_UNLIKELY(!node)) malloc_err();
-      node->type = _DIVIDE;
-      node->factors.left = $1;
-      node->factors.right = $3;
-      $$ = node;
-   }
-
-   |  expression GTEQ expression {  
-      ASTNode* node = malloc(sizeof(ASTNode));
-      if (GCC_UNLIKELY(!node)) malloc_err();
-      node->type = _GTEQ;
-      node->factors.left = $1;
-      node->factors.right = $3;
-      $$ = node;
-   }
-
-   |  expression LTEQ expression {  
-      ASTNode* node = malloc(sizeof(ASTNode));
-      if (GCC_UNLIKELY(!node)) malloc_err();
-      node->type = _LTEQ;
-      node->factors.left = $1;
-      node->factors.right = $3;
-      $$ = node;
-   }
-
-   |  expression '>' expression {  
-      ASTNode* node = malloc(sizeof(ASTNode));
-      if (GCC_UNLIKELY(!node)) malloc_err();
-      node->type = _GREATER;
-      node->factors.left = $1;
-      node->factors.right = $3;
-      $$ = node;
-   }
-
-   |  expression '<' expression {  
-      ASTNode* node = malloc(sizeof(ASTNode));
-      if (GCC_UNLIKELY(!node)) malloc_err();
-      node->type = _LESS;
-      node->factors.left = $1;
-      node->factors.right = $3;
-      $$ = node;
-   }
-
-   |  expression EQ expression {  
-      ASTNode* node = malloc(sizeof(ASTNode));
-      if (GCC_UNLIKELY(!node)) malloc_err();
-      node->type = _EQUALS;
-      node->factors.left = $1;
-      node->factors.right = $3;
-      $$ = node;
-   }
-
-   |  expression NEQ expression {  
-      ASTNode* node = malloc(sizeof(ASTNode));
-      if (GCC_UNLIKELY(!node)) malloc_err();
-      node->type = _NEQUALS;
-      node->factors.left = $1;
-      node->factors.right = $3;
-      $$ = node;
-   }
-
-   |  IDENTIFIER '(' declaration ')' ';' {
-      ASTNode* node = malloc(sizeof(ASTNode));
-      if (GCC_UNLIKELY(!node)) malloc_err();
-      node->type = _FUNCTION_CALL;
-      node->list.title = $1;
-      node->list.next = $3;
-      $$ = node;    
+   | '!' expression %prec UNARY {
+      $$ = ast_new_node(_NOT);
+      ast_node($$)->inner = $2;
+   }
+
+   | '-' expression %prec UNARY {
+      $$ = ast_new_node(_NEGATIVE);
+      ast_node($$)->inner = $2;
+   }
+
+   |  expression '+' expression { $$ = ast_new_binary(_ADD, $1, $3); }
+   |  expression '-' expression { $$ = ast_new_binary(_SUBTRACT, $1, $3); }
+   |  expression '*' expression { $$ = ast_new_binary(_MULTIPLY, $1, $3); }
+   |  expression '/' expression { $$ = ast_new_binary(_DIVIDE, $1, $3); }
+   |  expression GTEQ expression { $$ = ast_new_binary(_GTEQ, $1, $3); }
+   |  expression LTEQ expression { $$ = ast_new_binary(_LTEQ, $1, $3); }
+   |  expression '>' expression { $$ = ast_new_binary(_GREATER, $1, $3); }
+   |  expression '<' expression { $$ = ast_new_binary(_LESS, $1, $3); }
+   |  expression EQ expression { $$ = ast_new_binary(_EQUALS, $1, $3); }
+   |  expression NEQ expression { $$ = ast_new_binary(_NEQUALS, $1, $3); }
+
+   |  IDENTIFIER '(' parameters ')' {
+      $$ = ast_new_node(_FUNCTION_CALL);
+      ast_node($$)->list.title = $1;
+      ast_node($$)->list.items = $3;
    }
       
    |  IDENTIFIER INC {
-      ASTNode* node = malloc(sizeof(ASTNode));
-      if (GCC_UNLIKELY(!node)) malloc_err();
-      node->type = _INC;
-      node->string = $1;
-      $$ = node;
+      $$ = ast_new_node(_INC);
+      ast_node($$)->symbol = $1;
    }
    |  INC IDENTIFIER {
-      ASTNode* node = malloc(sizeof(ASTNode));
-      if (GCC_UNLIKELY(!node)) malloc_err();
-      node->type = _INC;
-      node->string = $2;
-      $$ = node;
+      $$ = ast_new_node(_INC);
+      ast_node($$)->symbol = $2;
    }
       
    |  IDENTIFIER DEC {
-      ASTNode* node = malloc(sizeof(ASTNode));
-      if (GCC_UNLIKELY(!node)) malloc_err();
-      node->type = _DEC;
-      node->string = $1;
-      $$ = node;
+      $$ = ast_new_node(_DEC);
+      ast_node($$)->symbol = $1;
    }
    |  DEC IDENTIFIER {
-      ASTNode* node = malloc(sizeof(ASTNode));
-      if (GCC_UNLIKELY(!node)) malloc_err();
-      node->type = _DEC;
-      node->string = $2;
-      $$ = node;
+      $$ = ast_new_node(_DEC);
+      ast_node($$)->symbol = $2;
    }
 
    |  IDENTIFIER array_reference { 
-      ASTNode* node = malloc(sizeof(ASTNode));
-      if (GCC_UNLIKELY(!node)) malloc_err();
-      node->type = _ARRAY_REF;
-      node->list.title = $1;
-      node->list.next = $2;
-      $$ = node;
+      $$ = ast_new_node(_ARRAY_REF);
+      ast_node($$)->list.title = $1;
+      ast_node($$)->list.items = $2;
    }
    
    |  IDENTIFIER {
-      ASTNode* node = malloc(sizeof(ASTNode));
-      if (GCC_UNLIKELY(!node)) malloc_err();
-      node->type = _VARIABLE;
-      node->string = $1;
-      $$ = node;
+      $$ = ast_new_node(_VARIABLE);
+      ast_node($$)->symbol = $1;
    }
 
    |  NUMBER {
-      ASTNode* node = malloc(sizeof(ASTNode));
-      if (GCC_UNLIKELY(!node)) malloc_err();
-      node->type = _NUMBER;
-      node->integer = $1;
-      $$ = node;
+      $$ = ast_new_node(_NUMBER);
+      ast_node($$)->integer = $1;
    }
 
    |  CHARACTER {
-      ASTNode* node = malloc(sizeof(ASTNode));
-      if (GCC_UNLIKELY(!node)) malloc_err();
-      node->type = _NUMBER;
-      node->integer = (int)$1;
-      $$ = node;
+      $$ = ast_new_node(_NUMBER);
+      ast_node($$)->integer = (int)$1;
    }
 
    ;
 
 declaration:
-   /* empty */ {
-      ASTNode* node = malloc(sizeof(ASTNode));
-      if (GCC_UNLIKELY(!node)) malloc_err();
-      node->type = STOP;
-      $$ = node;
+   /* empty */ { $$ = 0; }
+   |  declaration_list { $$ = ast_list_end($1); }
+   ;
+
+declaration_list:
+   declarator {
+      $$ = ast_list_begin();
+      ast_list_push($1);
    }
-   |  IDENTIFIER {
-      ASTNode* node = malloc(sizeof(ASTNode));
-      if (GCC_UNLIKELY(!node)) malloc_err();
-      node->type = _VARIABLE;
-      node->list.title = $1;
-      node->list.next = malloc(sizeof(ASTNode));
-      if (!node->list.next) malloc_err();
-      node->list.next->type = STOP;
-      $$ = node;
-   }
-   |  IDENTIFIER ',' declaration {
-      ASTNode* node = malloc(sizeof(ASTNode));
-      if (GCC_UNLIKELY(!node)) malloc_err();
-      node->type = _VARIABLE;
-      node->list.title = $1;
-      node->list.next = $3;
-      $$ = node;
-   }
-;
+   |  declaration_list ',' declarator {
+      ast_list_push($3);
+      $$ = $1;
+   }
+   ;
+
+declarator:
+   IDENTIFIER {
+      $$ = ast_new_node(_VARIABLE);
+      ast_node($$)->symbol = $1;
+   }
+   |  IDENTIFIER '[' NUMBER ']' {
+      $$ = ast_new_node(_ARRAY);
+      ast_node($$)->array.title = $1;
+      ast_node($$)->array.size = $3;
+   }
+   ;
 
 
 else:
-   /* empty */ {
-      ASTNode* node = malloc(sizeof(ASTNode));
-      if (GCC_UNLIKELY(!node)) malloc_err();
-      node->type = STOP;
-      $$ = node;
-   }
+   /* empty */ { $$ = 0; }
    | ELSE block { $$ = $2; }
    ;
 
 block:
-   '{' statement_list '}' { $$ = $2; }
-   | statement { $$ = $1; }
+   '{' statement_list '}' { $$ = ast_list_end($2); }
+   | statement { $$ = ast_list_of($1); }
    ;
 
 parameters:
-   /* empty */ {
-      ASTNode* node = malloc(sizeof(ASTNode));
-      if (GCC_UNLIKELY(!node)) malloc_err();
-      node->type = STOP;
-      $$ = node;
-   }
-   | expression {
-      ASTNode* node = malloc(sizeof(ASTNode));
-      if (GCC_UNLIKELY(!node)) malloc_err();
-      node->type = STOP;
-      $1->successor = node;
+   /* empty */ { $$ = 0; }
+   | parameter_list { $$ = ast_list_end($1); }
+   ;
+
+parameter_list:
+   expression {
+      $$ = ast_list_begin();
+      ast_list_push($1);
+   }
+   | parameter_list ',' expression {
+      ast_list_push($3);
       $$ = $1;
    }
-   | expression ',' parameters {
-      $1->successor = $3;
+   ;
+
+
+/* An external's initial values are constants or the addresses of other names. */
+initializers:
+   /* empty */ { $$ = 0; }
+   | initializer_list { $$ = ast_list_end($1); }
+   ;
+
+initializer_list:
+   initializer {
+      $$ = ast_list_begin();
+      ast_list_push($1);
+   }
+   | initializer_list ',' initializer {
+      ast_list_push($3);
       $$ = $1;
    }
+   ;
 
+initializer:
+   NUMBER {
+      $$ = ast_new_node(_NUMBER);
+      ast_node($$)->integer = $1;
+   }
+   | '-' NUMBER {
+      $$ = ast_new_node(_NUMBER);
+      ast_node($$)->integer = -$2;
+   }
+   | CHARACTER {
+      $$ = ast_new_node(_NUMBER);
+      ast_node($$)->integer = (int)$1;
+   }
+   | IDENTIFIER {
+      $$ = ast_new_node(_VARIABLE);
+      ast_node($$)->symbol = $1;
+   }
+   ;
 
 array_reference:
-   /* empty */ {
-      ASTNode* node = malloc(sizeof(ASTNode));
-      if (GCC_UNLIKELY(!node)) malloc_err();
-      node->type = STOP;
-      $$ = node;
-   }
-  | '[' expression ']' {
-        ASTNode* node = malloc(sizeof(ASTNode));
-      if (GCC_UNLIKELY(!node)) malloc_err();
-      node->type = _ARRAY;
-      node->list.inner = $2;
-      node->list.next = malloc(sizeof(ASTNode));
-      if (!node->list.next) malloc_err();
-      node->list.next->type = STOP;
-      $$ = node;
-    }
-  | '[' expression ']' array_reference {
-      ASTNode* node = malloc(sizeof(ASTNode));
-      if (GCC_UNLIKELY(!node)) malloc_err();
-      node->type = _ARRAY;
-      node->list.inner = $2;
-      node->list.next = $4;
-      $$ = node;
-    }
-;
+   subscripts { $$ = ast_list_end($1); }
+   ;
+
+subscripts:
+   '[' expression ']' {
+      $$ = ast_list_begin();
+      ast_list_push($2);
+   }
+   | subscripts '[' expression ']' {
+      ast_list_push($3);
+      $$ = $1;
+   }
+   ;
 
 %%
 
 void yyerror(const char *s) {
    fprintf(stderr, "Error: %s\n", s);
-}
-
-
-// The reason an ASTNode* might be equal to 0x000000000000002 is because the union WAS
-// setting it to 2, but then this integer was read as an ASTNode*.
\ No newline at end of file
+}
\ No newline at end of file
@@ -0,0 +1,101 @@
+/*
+   BLang
+   Copyright (c) 2025 William Gibbs
+
+   This software is provided 'as-is', without any express or implied
+   warranty. In no event will the authors be held liable for any damages
+   arising from the use of this software.
+
+   Permission is granted to anyone to use this software for any purpose,
+   including commercial applications, and to alter it and redistribute it
+   freely, subject to the following restrictions:
+
+   1. The origin of this software must not be misrepresented; you must not
+      claim that you wrote the original software. If you use this software
+      in a product, an acknowledgment in the product documentation would be
+      appreciated but is not required.
+   2. Altered source versions must be plainly marked as such, and must not be
+      misrepresented as being the original software.
+   3. This notice may not be removed or altered from any source distribution.
+*/
+
+/*
+ * blang-profdata: combine the profiles written by -fprofile-generate runs
+ * into one file for -fprofile-use, and inspect them.
+ *
+ *    blang-profdata merge [-o <output>] <profile>...
+ *    blang-profdata show <profile>
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "profile.h"
+#include "error.h"
+
+static void print_usage() {
+   printf(
+      "Usage: blang-profdata merge [-o <output>] <profile>...\n"
+      "       blang-profdata show <profile>\n"
+      "\n"
+      "  merge    Sum the counts of several runs (default output: default.profdata)\n"
+      "  show     List every function with its call count\n"
+   );
+   exit(EXIT_FAILURE);
+}
+
+static int merge(int argc, char *argv[]) {
+   const char *output = "default.profdata";
+   Profile merged = { 0 };
+   int inputs = 0;
+
+   for (int i = 0; i < argc; i++) {
+      if (strcmp(argv[i], "-o") == 0) {
+         if (i + 1 >= argc) fatal_error("missing file name after '-o'");
+         output = argv[++i];
+         continue;
+      }
+
+      Profile profile = { 0 };
+      if (!profile_read(&profile, argv[i])) fatal_error("could not read profile \"%s\"", argv[i]);
+
+      for (size_t r = 0; r < profile.length; r++)
+         if (!profile_merge(&merged, &profile.records[r]))
+            warning("%s in \"%s\" does not match the other profiles, skipped", profile.records[r].name, argv[i]);
+
+      profile_release(&profile);
+      inputs++;
+   }
+
+   if (inputs == 0) print_usage();
+   if (!profile_write(&merged, output)) fatal_error("could not write profile \"%s\"", output);
+
+   profile_release(&merged);
+   return EXIT_SUCCESS;
+}
+
+static int show(const char *path) {
+   Profile profile = { 0 };
+   if (!profile_read(&profile, path)) fatal_error("could not read profile \"%s\"", path);
+
+   for (size_t i = 0; i < profile.length; i++) {
+      const ProfileRecord *record = &profile.records[i];
+      printf("%-32s %12llu calls  %4u branches  hash %016llx\n", record->name,
+         (unsigned long long)(record->count ? record->counters[0] : 0),
+         record->count ? (record->count - 1) / 2 : 0, (unsigned long long)record->hash);
+   }
+
+   profile_release(&profile);
+   return EXIT_SUCCESS;
+}
+
+int main(int argc, char *argv[]) {
+   if (argc < 2) print_usage();
+
+   if (strcmp(argv[1], "merge") == 0) return merge(argc - 2, argv + 2);
+   if (strcmp(argv[1], "show") == 0 && argc == 3) return show(argv[2]);
+
+   print_usage();
+   return EXIT_FAILURE;
+}
\ No newline at end of file
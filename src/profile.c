@@ -0,0 +1,118 @@
+/*
+   BLang
+   Copyright (c) 2025 William Gibbs
+
+   This software is provided 'as-is', without any express or implied
+   warranty. In no event will the authors be held liable for any damages
+   arising from the use of this software.
+
+   Permission is granted to anyone to use this software for any purpose,
+   including commercial applications, and to alter it and redistribute it
+   freely, subject to the following restrictions:
+
+   1. The origin of this software must not be misrepresented; you must not
+      claim that you wrote the original software. If you use this software
+      in a product, an acknowledgment in the product documentation would be
+      appreciated but is not required.
+   2. Altered source versions must be plainly marked as such, and must not be
+      misrepresented as being the original software.
+   3. This notice may not be removed or altered from any source distribution.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "profile.h"
+#include "error.h"
+
+static ProfileRecord* add_record(Profile* profile, const char* name, uint64_t hash, uint32_t count) {
+   if (profile->length == profile->capacity) {
+      size_t capacity = profile->capacity ? profile->capacity * 2 : 64;
+      ProfileRecord* records = realloc(profile->records, capacity * sizeof(ProfileRecord));
+      if (!records) fatal_error("failed to allocate memory for the profile");
+      profile->records = records;
+      profile->capacity = capacity;
+   }
+
+   ProfileRecord* record = &profile->records[profile->length++];
+   record->name = strdup(name);
+   record->hash = hash;
+   record->count = count;
+   record->counters = calloc(count ? count : 1, sizeof(uint64_t));
+   if (!record->name || !record->counters) fatal_error("failed to allocate memory for the profile");
+   return record;
+}
+
+bool profile_read(Profile* profile, const char* path) {
+   FILE* f = fopen(path, "r");
+   if (!f) return false;
+
+   char name[256];
+   unsigned long long hash;
+   unsigned count;
+   bool ok = true;
+
+   while (fscanf(f, "%255s %llu %u", name, &hash, &count) == 3) {
+      ProfileRecord record = { name, hash, count, calloc(count ? count : 1, sizeof(uint64_t)) };
+      if (!record.counters) fatal_error("failed to allocate memory for the profile");
+
+      for (unsigned i = 0; i < count && ok; i++) {
+         unsigned long long counter;
+         ok = fscanf(f, "%llu", &counter) == 1;
+         record.counters[i] = counter;
+      }
+
+      // A function seen twice (several raw profiles concatenated) is summed.
+      if (ok && !profile_merge(profile, &record))
+         warning("profile \"%s\" has two different versions of %s, keeping the first", path, name);
+      free(record.counters);
+      if (!ok) break;
+   }
+
+   ok = ok && feof(f);
+   fclose(f);
+   return ok;
+}
+
+bool profile_write(const Profile* profile, const char* path) {
+   FILE* f = fopen(path, "w");
+   if (!f) return false;
+
+   for (size_t i = 0; i < profile->length; i++) {
+      const ProfileRecord* record = &profile->records[i];
+      fprintf(f, "%s %llu %u", record->name, (unsigned long long)record->hash, record->count);
+      for (uint32_t c = 0; c < record->count; c++)
+         fprintf(f, " %llu", (unsigned long long)record->counters[c]);
+      fputc('\n', f);
+   }
+
+   return fclose(f) == 0;
+}
+
+ProfileRecord* profile_find(const Profile* profile, const char* name) {
+   for (size_t i = 0; i < profile->length; i++)
+      if (strcmp(profile->records[i].name, name) == 0) return &profile->records[i];
+   return NULL;
+}
+
+bool profile_merge(Profile* profile, const ProfileRecord* record) {
+   ProfileRecord* into = profile_find(profile, record->name);
+   if (!into) into = add_record(profile, record->name, record->hash, record->count);
+   else if (into->hash != record->hash || into->count != record->count) return false;
+
+   for (uint32_t i = 0; i < record->count; i++) {
+      uint64_t sum = into->counters[i] + record->counters[i];
+      into->counters[i] = sum < into->counters[i] ? UINT64_MAX : sum;   // saturate
+   }
+   return true;
+}
+
+void profile_release(Profile* profile) {
+   for (size_t i = 0; i < profile->length; i++) {
+      free(profile->records[i].name);
+      free(profile->records[i].counters);
+   }
+   free(profile->records);
+   *profile = (Profile){ 0 };
+}
\ No newline at end of file
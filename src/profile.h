@@ -0,0 +1,72 @@
+/*
+   BLang
+   Copyright (c) 2025 William Gibbs
+
+   This software is provided 'as-is', without any express or implied
+   warranty. In no event will the authors be held liable for any damages
+   arising from the use of this software.
+
+   Permission is granted to anyone to use this software for any purpose,
+   including commercial applications, and to alter it and redistribute it
+   freely, subject to the following restrictions:
+
+   1. The origin of this software must not be misrepresented; you must not
+      claim that you wrote the original software. If you use this software
+      in a product, an acknowledgment in the product documentation would be
+      appreciated but is not required.
+   2. Altered source versions must be plainly marked as such, and must not be
+      misrepresented as being the original software.
+   3. This notice may not be removed or altered from any source distribution.
+*/
+
+#ifndef PROFILE_H
+#define PROFILE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Execution counts written by -fprofile-generate programs, merged by
+ * blang-profdata and read back by -fprofile-use. The file is text, one
+ * function per line:
+ *
+ *    <name> <hash> <count> <counter 0> ... <counter count-1>
+ *
+ * Counter 0 counts calls. Every if and while condition then has a pair,
+ * in the order the IR generator visits them: how often the condition was
+ * tested, and how often it was true. The hash covers that shape, so counts
+ * are never applied to a function that has since changed.
+ */
+typedef struct ProfileRecord {
+   char* name;
+   uint64_t hash;
+   uint32_t count;
+   uint64_t* counters;
+} ProfileRecord;
+
+typedef struct Profile {
+   ProfileRecord* records;
+   size_t length;
+   size_t capacity;
+} Profile;
+
+bool profile_read(Profile* profile, const char* path);
+bool profile_write(const Profile* profile, const char* path);
+ProfileRecord* profile_find(const Profile* profile, const char* name);
+
+// Add a record's counts to the profile's record of the same function.
+// Returns false, leaving the profile unchanged, when the hashes differ.
+bool profile_merge(Profile* profile, const ProfileRecord* record);
+
+void profile_release(Profile* profile);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // PROFILE_H
\ No newline at end of file
@@ -0,0 +1,442 @@
+/*
+   BLang
+   Copyright (c) 2025 William Gibbs
+
+   This software is provided 'as-is', without any express or implied
+   warranty. In no event will the authors be held liable for any damages
+   arising from the use of this software.
+
+   Permission is granted to anyone to use this software for any purpose,
+   including commercial applications, and to alter it and redistribute it
+   freely, subject to the following restrictions:
+
+   1. The origin of this software must not be misrepresented; you must not
+      claim that you wrote the original software. If you use this software
+      in a product, an acknowledgment in the product documentation would be
+      appreciated but is not required.
+   2. Altered source versions must be plainly marked as such, and must not be
+      misrepresented as being the original software.
+   3. This notice may not be removed or altered from any source distribution.
+*/
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "simplify.h"
+#include "ast.h"
+#include "context.h"
+#include "error.h"
+#include "opt.h"
+
+/*
+ * Expressions are rewritten in place, so nothing here allocates a node and
+ * the index a parent holds stays valid. Statement lists that lose or gain
+ * statements are copied out anew through the scratch stack; ast_lists may
+ * move while that happens, so list items are always looked up afresh.
+ *
+ * Expression trees are walked from an explicit work stack, not by
+ * recursion, so an expression a hundred thousand operators deep costs heap
+ * rather than native stack. A walk may start another on top of the stack;
+ * it pops back down to where it began before returning.
+ */
+
+static inline bool is_binary(uint8_t type) { return type >= _ADD && type <= _NEQUALS; }
+static inline bool is_number(ASTIndex index) { return ast_node(index)->type == _NUMBER; }
+static inline bool is_value(ASTIndex index, int value) { return is_number(index) && ast_node(index)->integer == value; }
+
+// Results that do not fit a node are left to run time, which works in 64 bits.
+static void make_number(ASTIndex index, int64_t value) {
+    if (value < INT32_MIN || value > INT32_MAX) return;
+    ASTNode* node = ast_node(index);
+    node->type = _NUMBER;
+    node->integer = (int)value;
+}
+
+// The node at index takes over the contents of one of its own children.
+static void replace(ASTIndex index, ASTIndex with) {
+    *ast_node(index) = *ast_node(with);
+}
+
+static void negate(ASTIndex index, ASTIndex operand) {
+    if (ast_node(operand)->type == _NEGATIVE) {
+        replace(index, ast_node(operand)->inner);
+        return;
+    }
+    ASTNode* node = ast_node(index);
+    node->type = _NEGATIVE;
+    node->inner = operand;
+}
+
+typedef struct WorkItem {
+    ASTIndex index;
+    bool expanded;          // children done, fold the node itself
+} WorkItem;
+
+static WorkItem* work = NULL;
+static uint32_t work_length = 0;
+static uint32_t work_capacity = 0;
+
+static void push_work(ASTIndex index, bool expanded) {
+    if (GCC_UNLIKELY(work_length == work_capacity)) {
+        work_capacity = work_capacity ? work_capacity * 2 : 256;
+        work = realloc(work, work_capacity * sizeof(WorkItem));
+        if (GCC_UNLIKELY(!work)) fatal_error("failed to allocate space for the AST.");
+    }
+    work[work_length++] = (WorkItem){ index, expanded };
+}
+
+static void push_items(ASTList list) {
+    for (uint32_t i = ast_list_length(list); i > 0; i--)
+        push_work(ast_list_items(list)[i - 1], false);
+}
+
+static bool has_side_effects(ASTIndex index) {
+    uint32_t mark = work_length;
+    push_work(index, false);
+    while (work_length > mark) {
+        ASTNode* node = ast_node(work[--work_length].index);
+        switch (node->type) {
+            case _FUNCTION_CALL:
+            case _INC:
+            case _DEC:
+                work_length = mark;
+                return true;
+            case _NOT:
+            case _NEGATIVE:
+                push_work(node->inner, false);
+                break;
+            case _ARRAY_REF:
+                push_items(node->list.items);
+                break;
+            default:
+                if (is_binary(node->type)) {
+                    push_work(node->factors.right, false);
+                    push_work(node->factors.left, false);
+                }
+                break;
+        }
+    }
+    return false;
+}
+
+// Folds a binary operator whose operands are already simplified.
+static void fold_binary(ASTIndex index) {
+    ASTNode* node = ast_node(index);
+    ASTIndex left = node->factors.left;
+    ASTIndex right = node->factors.right;
+
+    if (is_number(left) && is_number(right)) {
+        int64_t a = ast_node(left)->integer;
+        int64_t b = ast_node(right)->integer;
+        switch (node->type) {
+            case _ADD:      make_number(index, a + b); break;
+            case _SUBTRACT: make_number(index, a - b); break;
+            case _MULTIPLY: make_number(index, a * b); break;
+            case _DIVIDE:   if (b != 0) make_number(index, a / b); break;  // x/0 still traps at run time
+            case _GTEQ:     make_number(index, a >= b); break;
+            case _LTEQ:     make_number(index, a <= b); break;
+            case _GREATER:  make_number(index, a > b); break;
+            case _LESS:     make_number(index, a < b); break;
+            case _EQUALS:   make_number(index, a == b); break;
+            case _NEQUALS:  make_number(index, a != b); break;
+        }
+        return;
+    }
+
+    switch (node->type) {
+        case _ADD:
+            if (is_value(right, 0)) replace(index, left);
+            else if (is_value(left, 0)) replace(index, right);
+            break;
+        case _SUBTRACT:
+            if (is_value(right, 0)) replace(index, left);
+            else if (is_value(left, 0)) negate(index, right);
+            break;
+        case _MULTIPLY:
+            if (is_value(right, 1)) replace(index, left);
+            else if (is_value(left, 1)) replace(index, right);
+            else if (is_value(right, -1)) negate(index, left);
+            else if (is_value(left, -1)) negate(index, right);
+            // The other operand still has to run if it calls or increments.
+            else if ((is_value(right, 0) && !has_side_effects(left)) ||
+                     (is_value(left, 0) && !has_side_effects(right)))
+                make_number(index, 0);
+            break;
+        case _DIVIDE:
+            if (is_value(right, 1)) replace(index, left);
+            else if (is_value(right, -1)) negate(index, left);
+            break;
+    }
+}
+
+static void fold(ASTIndex index) {
+    ASTNode* node = ast_node(index);
+    switch (node->type) {
+        case _NOT:
+            if (is_number(node->inner))
+                make_number(index, !ast_node(node->inner)->integer);
+            break;
+        case _NEGATIVE:
+            if (is_number(node->inner))
+                make_number(index, -(int64_t)ast_node(node->inner)->integer);
+            else
+                negate(index, node->inner);
+            break;
+        default:
+            fold_binary(index);
+            break;
+    }
+}
+
+// Simplifies the tree under index bottom-up, operands before their operator.
+static void simplify_expression(ASTIndex index) {
+    uint32_t mark = work_length;
+    push_work(index, false);
+    while (work_length > mark) {
+        WorkItem item = work[--work_length];
+        ASTNode* node = ast_node(item.index);
+        if (item.expanded) {
+            fold(item.index);
+            continue;
+        }
+
+        switch (node->type) {
+            case _NOT:
+            case _NEGATIVE:
+                push_work(item.index, true);
+                push_work(node->inner, false);
+                break;
+            case _FUNCTION_CALL:
+            case _ARRAY_REF:
+                push_items(node->list.items);
+                break;
+            default:
+                if (is_binary(node->type)) {
+                    push_work(item.index, true);
+                    push_work(node->factors.right, false);
+                    push_work(node->factors.left, false);
+                }
+                break;
+        }
+    }
+}
+
+static void simplify_items(ASTList list) {
+    for (uint32_t i = 0; i < ast_list_length(list); i++)
+        simplify_expression(ast_list_items(list)[i]);
+}
+
+static bool contains_label(ASTList list);
+
+static bool statement_contains_label(ASTIndex index) {
+    ASTNode* node = ast_node(index);
+    switch (node->type) {
+        case _LABEL:
+            return true;
+        case _WHILE_LOOP:
+            return contains_label(node->loop.statements);
+        case _IF:
+            return contains_label(node->if_t.statements) || contains_label(node->if_t.else_t);
+        default:
+            return false;
+    }
+}
+
+static bool contains_label(ASTList list) {
+    for (uint32_t i = 0; i < ast_list_length(list); i++)
+        if (statement_contains_label(ast_list_items(list)[i])) return true;
+    return false;
+}
+
+static ASTList simplify_statements(ASTList list);
+static void add_statements(ASTList list, bool* reachable);
+static void add_declarations(ASTList list);
+
+/**
+ * Keeps the auto and extrn declarations of a statement that is dropped:
+ * they name the variable for the whole function, not just their block.
+ */
+static void add_declaration(ASTIndex index) {
+    ASTNode* node = ast_node(index);
+    switch (node->type) {
+        case _AUTO:
+        case _EXTRN:
+            ast_list_push(index);
+            break;
+        case _WHILE_LOOP:
+            add_declarations(node->loop.statements);
+            break;
+        case _IF:
+            add_declarations(node->if_t.statements);
+            add_declarations(node->if_t.else_t);
+            break;
+        default:
+            break;
+    }
+}
+
+static void add_declarations(ASTList list) {
+    for (uint32_t i = 0; i < ast_list_length(list); i++)
+        add_declaration(ast_list_items(list)[i]);
+}
+
+/**
+ * Simplifies one statement and pushes what is left of it onto the list
+ * being built. A constant if is spliced into that list in place of itself,
+ * so its statements take part in the same reachability walk.
+ */
+static void add_statement(ASTIndex index, bool* reachable) {
+    ASTNode* node = ast_node(index);
+    if (node->type == _LABEL) *reachable = true;
+
+    // Nothing falls through a return or goto; only a jump to a label gets
+    // past one. Declarations stay, since they scope the rest of the body.
+    if (!*reachable && !statement_contains_label(index)) {
+        add_declaration(index);
+        return;
+    }
+
+    switch (node->type) {
+        case _ASSIGNMENT:
+            simplify_expression(node->assign.value);
+            break;
+        case _ARRAY_ASSIGNMENT:
+            simplify_expression(node->factors.left);
+            simplify_expression(node->factors.right);
+            break;
+        case _RETURN:
+            simplify_expression(node->inner);
+            break;
+        case _FUNCTION_CALL:
+            simplify_items(node->list.items);
+            break;
+        case _WHILE_LOOP:
+            simplify_expression(node->loop.cond);
+            if (is_value(node->loop.cond, 0) && !contains_label(node->loop.statements)) {
+                add_declarations(node->loop.statements);
+                return;
+            }
+            {
+                ASTList statements = simplify_statements(node->loop.statements);
+                ast_node(index)->loop.statements = statements;
+            }
+            break;
+        case _IF:
+            simplify_expression(node->if_t.cond);
+            if (is_number(node->if_t.cond) &&
+                !contains_label(node->if_t.statements) && !contains_label(node->if_t.else_t)) {
+                // The arms keep their order, so declarations come where they did.
+                ASTList else_t = node->if_t.else_t;
+                if (ast_node(node->if_t.cond)->integer) {
+                    add_statements(node->if_t.statements, reachable);
+                    add_declarations(else_t);
+                } else {
+                    add_declarations(node->if_t.statements);
+                    add_statements(else_t, reachable);
+                }
+                return;
+            }
+            {
+                ASTList statements = simplify_statements(node->if_t.statements);
+                ast_node(index)->if_t.statements = statements;
+                ASTList else_t = simplify_statements(ast_node(index)->if_t.else_t);
+                ast_node(index)->if_t.else_t = else_t;
+            }
+            break;
+        default:
+            break;
+    }
+
+    ast_list_push(index);
+    node = ast_node(index);
+    if (node->type == _RETURN || node->type == _GOTO) *reachable = false;
+}
+
+static void add_statements(ASTList list, bool* reachable) {
+    for (uint32_t i = 0; i < ast_list_length(list); i++)
+        add_statement(ast_list_items(list)[i], reachable);
+}
+
+// A list comes back as is unless one of its statements went away or was spliced.
+static ASTList simplify_statements(ASTList list) {
+    if (ast_list_length(list) == 0) return list;
+    bool reachable = true;
+    uint32_t mark = ast_list_begin();
+    add_statements(list, &reachable);
+    return ast_list_update(mark, list);
+}
+
+static uint32_t count_nodes(ASTIndex index) {
+    uint32_t mark = work_length;
+    uint32_t count = 0;
+    push_work(index, false);
+    while (work_length > mark) {
+        ASTNode* node = ast_node(work[--work_length].index);
+        if (node->type == STOP) continue;
+        count++;
+
+        switch (node->type) {
+            case _GLOBAL_DECLARATION:
+                push_items(node->global.values);
+                break;
+            case _AUTO:
+            case _EXTRN:
+            case _FUNCTION_CALL:
+            case _ARRAY_REF:
+                push_items(node->list.items);
+                break;
+            case _ASSIGNMENT:
+                push_work(node->assign.value, false);
+                break;
+            case _WHILE_LOOP:
+                push_work(node->loop.cond, false);
+                push_items(node->loop.statements);
+                break;
+            case _IF:
+                push_work(node->if_t.cond, false);
+                push_items(node->if_t.statements);
+                push_items(node->if_t.else_t);
+                break;
+            case _RETURN:
+            case _NOT:
+            case _NEGATIVE:
+                push_work(node->inner, false);
+                break;
+            case _FUNCTION:
+                push_items(node->function.args);
+                push_items(node->function.statements);
+                break;
+            default:
+                if (node->type == _ARRAY_ASSIGNMENT || is_binary(node->type)) {
+                    push_work(node->factors.left, false);
+                    push_work(node->factors.right, false);
+                }
+                break;
+        }
+    }
+    return count;
+}
+
+// Totals over the definitions of a file, for -v.
+static uint32_t nodes_before = 0;
+static uint32_t nodes_after = 0;
+
+void simplify_ast(ASTIndex definition) {
+    if (ast_node(definition)->type != _FUNCTION) return;
+    if (ctx.verbose) nodes_before += count_nodes(definition);
+
+    ASTList statements = simplify_statements(ast_node(definition)->function.statements);
+    ast_node(definition)->function.statements = statements;
+
+    if (ctx.verbose) nodes_after += count_nodes(definition);
+
+    free(work);
+    work = NULL;
+    work_capacity = 0;
+}
+
+void print_simplify_stats() {
+    fprintf(stderr, "blang: simplify: %u of %u AST nodes removed\n", nodes_before - nodes_after, nodes_before);
+    nodes_before = nodes_after = 0;
+}
\ No newline at end of file
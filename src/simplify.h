@@ -0,0 +1,47 @@
+/*
+   BLang
+   Copyright (c) 2025 William Gibbs
+
+   This software is provided 'as-is', without any express or implied
+   warranty. In no event will the authors be held liable for any damages
+   arising from the use of this software.
+
+   Permission is granted to anyone to use this software for any purpose,
+   including commercial applications, and to alter it and redistribute it
+   freely, subject to the following restrictions:
+
+   1. The origin of this software must not be misrepresented; you must not
+      claim that you wrote the original software. If you use this software
+      in a product, an acknowledgment in the product documentation would be
+      appreciated but is not required.
+   2. Altered source versions must be plainly marked as such, and must not be
+      misrepresented as being the original software.
+   3. This notice may not be removed or altered from any source distribution.
+*/
+
+
+#ifndef SIMPLIFY_H
+#define SIMPLIFY_H
+
+#include "ast.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Rewrites a parsed function before IR generation: folds constant
+ * expressions and algebraic identities, drops the dead arm of an if or
+ * while with a constant condition and the statements no label can reach
+ * after a return or goto. Externals are left as they are.
+ */
+void simplify_ast(ASTIndex definition);
+
+// Under -v, how many nodes simplify_ast() removed from the file.
+void print_simplify_stats();
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SIMPLIFY_H
\ No newline at end of file
@@ -0,0 +1,123 @@
+/*
+   BLang
+   Copyright (c) 2025 William Gibbs
+
+   This software is provided 'as-is', without any express or implied
+   warranty. In no event will the authors be held liable for any damages
+   arising from the use of this software.
+
+   Permission is granted to anyone to use this software for any purpose,
+   including commercial applications, and to alter it and redistribute it
+   freely, subject to the following restrictions:
+
+   1. The origin of this software must not be misrepresented; you must not
+      claim that you wrote the original software. If you use this software
+      in a product, an acknowledgment in the product documentation would be
+      appreciated but is not required.
+   2. Altered source versions must be plainly marked as such, and must not be
+      misrepresented as being the original software.
+   3. This notice may not be removed or altered from any source distribution.
+*/
+
+#include "symtab.h"
+#include "arena.h"
+#include "error.h"
+#include "opt.h"
+#include <stdlib.h>
+#include <string.h>
+
+typedef struct Bucket {
+    uint32_t hash;
+    Symbol symbol;       // 0 marks an empty bucket
+} Bucket;
+
+static Bucket* buckets = NULL;
+static uint32_t bucket_mask = 0;
+
+static const char** names = NULL;   // names[symbol]
+static uint32_t* lengths = NULL;    // lengths[symbol]
+static uint32_t name_count = 0;
+static uint32_t name_capacity = 0;
+
+GCC_PURE static inline uint32_t hash_text(const char* text, size_t length) {
+    uint32_t hash = 2166136261u;    // FNV-1a
+    for (size_t i = 0; i < length; i++) {
+        hash ^= (unsigned char)text[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+GCC_COLD static void grow_buckets() {
+    uint32_t capacity = bucket_mask ? (bucket_mask + 1) * 2 : 1024;
+    Bucket* grown = calloc(capacity, sizeof(Bucket));
+    if (GCC_UNLIKELY(!grown)) fatal_error("failed to allocate the symbol table.");
+
+    for (uint32_t i = 0; bucket_mask && i <= bucket_mask; i++) {
+        if (!buckets[i].symbol) continue;
+        uint32_t slot = buckets[i].hash & (capacity - 1);
+        while (grown[slot].symbol) slot = (slot + 1) & (capacity - 1);
+        grown[slot] = buckets[i];
+    }
+
+    free(buckets);
+    buckets = grown;
+    bucket_mask = capacity - 1;
+}
+
+GCC_COLD static void grow_names() {
+    name_capacity = name_capacity ? name_capacity * 2 : 512;
+    names = realloc(names, sizeof(*names) * name_capacity);
+    lengths = realloc(lengths, sizeof(*lengths) * name_capacity);
+    if (GCC_UNLIKELY(!names || !lengths)) fatal_error("failed to allocate the symbol table.");
+    if (name_count == 0) {
+        names[0] = "";
+        lengths[0] = 0;
+        name_count = 1;
+    }
+}
+
+Symbol intern(const char* text, size_t length) {
+    // Keep the load factor at or below one half.
+    if (GCC_UNLIKELY(name_count * 2 >= bucket_mask)) grow_buckets();
+
+    uint32_t hash = hash_text(text, length);
+    uint32_t slot = hash & bucket_mask;
+
+    while (buckets[slot].symbol) {
+        Symbol symbol = buckets[slot].symbol;
+        if (buckets[slot].hash == hash && lengths[symbol] == length
+                && memcmp(names[symbol], text, length) == 0)
+            return symbol;
+        slot = (slot + 1) & bucket_mask;
+    }
+
+    if (GCC_UNLIKELY(name_count >= name_capacity)) grow_names();
+
+    Symbol symbol = name_count++;
+    names[symbol] = arena_strdup(text, length);
+    lengths[symbol] = (uint32_t)length;
+    buckets[slot].hash = hash;
+    buckets[slot].symbol = symbol;
+    return symbol;
+}
+
+const char* symbol_name(Symbol symbol) {
+    return names[symbol];
+}
+
+uint32_t symbol_count(void) {
+    return name_count;
+}
+
+void symtab_release(void) {
+    free(buckets);
+    free(names);
+    free(lengths);
+    buckets = NULL;
+    names = NULL;
+    lengths = NULL;
+    bucket_mask = 0;
+    name_count = 0;
+    name_capacity = 0;
+}
\ No newline at end of file
@@ -0,0 +1,48 @@
+/*
+   BLang
+   Copyright (c) 2025 William Gibbs
+
+   This software is provided 'as-is', without any express or implied
+   warranty. In no event will the authors be held liable for any damages
+   arising from the use of this software.
+
+   Permission is granted to anyone to use this software for any purpose,
+   including commercial applications, and to alter it and redistribute it
+   freely, subject to the following restrictions:
+
+   1. The origin of this software must not be misrepresented; you must not
+      claim that you wrote the original software. If you use this software
+      in a product, an acknowledgment in the product documentation would be
+      appreciated but is not required.
+   2. Altered source versions must be plainly marked as such, and must not be
+      misrepresented as being the original software.
+   3. This notice may not be removed or altered from any source distribution.
+*/
+
+#ifndef SYMTAB_H
+#define SYMTAB_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Identifiers are interned once by the lexer and referred to by a dense
+ * integer ID from then on. ID 0 is never handed out, so it can be used to
+ * mean "no symbol". Names live in the AST arena and are released with it.
+ */
+typedef uint32_t Symbol;
+
+Symbol intern(const char* text, size_t length);
+const char* symbol_name(Symbol symbol);
+uint32_t symbol_count(void);
+void symtab_release(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SYMTAB_H
\ No newline at end of file
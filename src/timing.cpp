@@ -0,0 +1,222 @@
+/*
+   BLang
+   Copyright (c) 2025 William Gibbs
+
+   This software is provided 'as-is', without any express or implied
+   warranty. In no event will the authors be held liable for any damages
+   arising from the use of this software.
+
+   Permission is granted to anyone to use this software for any purpose,
+   including commercial applications, and to alter it and redistribute it
+   freely, subject to the following restrictions:
+
+   1. The origin of this software must not be misrepresented; you must not
+      claim that you wrote the original software. If you use this software
+      in a product, an acknowledgment in the product documentation would be
+      appreciated but is not required.
+   2. Altered source versions must be plainly marked as such, and must not be
+      misrepresented as being the original software.
+   3. This notice may not be removed or altered from any source distribution.
+*/
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "timing.h"
+#include "context.h"
+#include "error.h"
+#include "opt.h"
+
+#include <llvm/ADT/SmallString.h>
+#include <llvm/Pass.h>
+#include <llvm/Support/Error.h>
+#include <llvm/Support/FileSystem.h>
+#include <llvm/Support/JSON.h>
+#include <llvm/Support/MemoryBuffer.h>
+#include <llvm/Support/Path.h>
+#include <llvm/Support/TimeProfiler.h>
+#include <llvm/Support/raw_ostream.h>
+
+using Clock = std::chrono::steady_clock;
+
+// One row of the -ftime-report table, summed over every run of the phase.
+struct Phase {
+   const char* name;
+   unsigned depth;
+   unsigned count;
+   double seconds;
+};
+
+struct OpenPhase {
+   size_t phase;
+   Clock::time_point start;
+};
+
+// A worker process's -ftime-trace, waiting to be merged into this one's.
+struct WorkerTrace {
+   std::string source;
+   llvm::json::Object trace;
+};
+
+static bool tracing = false;
+static bool reporting = false;
+
+// Rows in the order the phases first ran, so nested phases follow their parent.
+static std::vector<Phase> phases;
+static std::vector<OpenPhase> open;
+static std::vector<WorkerTrace> workers;
+
+extern "C" void timing_initialize() {
+   tracing = ctx.timeTrace;
+   reporting = ctx.timeReport;
+
+   if (tracing)
+      llvm::timeTraceProfilerInitialize(ctx.timeTraceGranularity, "blang");
+
+   // Per-pass timers for the optimization pipeline and code generation.
+   if (reporting)
+      llvm::TimePassesIsEnabled = true;
+}
+
+// The row for `name` nested in the phases open now, added the first time it runs.
+static size_t find_phase(const char* name) {
+   unsigned depth = open.size();
+   size_t phase = 0;
+   while (phase < phases.size() && (phases[phase].depth != depth || strcmp(phases[phase].name, name) != 0))
+      phase++;
+   if (phase == phases.size())
+      phases.push_back({ name, depth, 0, 0.0 });
+   return phase;
+}
+
+extern "C" void timing_begin(const char* name, const char* detail) {
+   if (GCC_LIKELY(!tracing && !reporting)) return;
+
+   if (tracing)
+      llvm::timeTraceProfilerBegin(name, detail ? detail : "");
+
+   if (reporting)
+      open.push_back({ find_phase(name), Clock::now() });
+}
+
+extern "C" void timing_end() {
+   if (GCC_LIKELY(!tracing && !reporting)) return;
+
+   if (tracing)
+      llvm::timeTraceProfilerEnd();
+
+   if (reporting && !open.empty()) {
+      Phase& phase = phases[open.back().phase];
+      phase.seconds += std::chrono::duration<double>(Clock::now() - open.back().start).count();
+      phase.count++;
+      open.pop_back();
+   }
+}
+
+extern "C" double timing_now() {
+   if (GCC_LIKELY(!tracing && !reporting)) return 0;
+   return std::chrono::duration<double>(Clock::now().time_since_epoch()).count();
+}
+
+extern "C" void timing_record(const char* name, double seconds, unsigned count) {
+   if (!reporting) return;
+
+   Phase& phase = phases[find_phase(name)];
+   phase.seconds += seconds;
+   phase.count += count;
+}
+
+static void print_report() {
+   double total = 0;
+   for (const Phase& phase : phases)
+      if (phase.depth == 0) total += phase.seconds;
+
+   fprintf(stderr,
+      "===-------------------------------------------------------------------------===\n"
+      "                          blang compilation time report\n"
+      "===-------------------------------------------------------------------------===\n"
+      "  Total: %.4f seconds\n\n"
+      "   Wall Time (s)   ---%%---     Count   Phase\n", total);
+
+   for (const Phase& phase : phases)
+      fprintf(stderr, "  %14.4f   %6.1f%%  %8u   %*s%s\n",
+         phase.seconds, total > 0 ? phase.seconds * 100.0 / total : 0.0,
+         phase.count, (int)phase.depth * 2, "", phase.name);
+}
+
+static llvm::json::Value read_trace(const char* path) {
+   auto buffer = llvm::MemoryBuffer::getFile(path);
+   if (!buffer)
+      fatal_error("could not read time trace \"%s\": %s", path, buffer.getError().message().c_str());
+   auto trace = llvm::json::parse((*buffer)->getBuffer());
+   if (!trace)
+      fatal_error("could not parse time trace \"%s\": %s", path, llvm::toString(trace.takeError()).c_str());
+   return std::move(*trace);
+}
+
+extern "C" void timing_merge(const char* trace, const char* source) {
+   if (!tracing) return;
+
+   // A worker that failed before timing_finish() left the file empty.
+   uint64_t size = 0;
+   if (!llvm::sys::fs::file_size(trace, size) && size > 0) {
+      llvm::json::Value value = read_trace(trace);
+      if (llvm::json::Object* object = value.getAsObject())
+         workers.push_back({ source, std::move(*object) });
+   }
+   llvm::sys::fs::remove(trace);
+}
+
+/**
+ * Appends the workers' events to the trace at `path`. Each process counts
+ * time from its own beginningOfTime, so their events are shifted onto this
+ * one's clock, and each worker's process is named after its source.
+ */
+static void merge_workers(const char* path) {
+   llvm::json::Value value = read_trace(path);
+   llvm::json::Object* trace = value.getAsObject();
+   llvm::json::Array* events = trace ? trace->getArray("traceEvents") : nullptr;
+   if (!events) fatal_error("time trace \"%s\" has no traceEvents", path);
+   int64_t begin = trace->getInteger("beginningOfTime").value_or(0);
+
+   for (WorkerTrace& worker : workers) {
+      llvm::json::Array* workerEvents = worker.trace.getArray("traceEvents");
+      if (!workerEvents) continue;
+      int64_t offset = worker.trace.getInteger("beginningOfTime").value_or(begin) - begin;
+
+      for (llvm::json::Value& workerEvent : *workerEvents) {
+         llvm::json::Object* event = workerEvent.getAsObject();
+         if (!event) continue;
+         if (auto ts = event->getInteger("ts")) (*event)["ts"] = *ts + offset;
+         if (event->getString("name") == llvm::StringRef("process_name"))
+            if (llvm::json::Object* args = event->getObject("args")) (*args)["name"] = worker.source;
+         events->push_back(std::move(workerEvent));
+      }
+   }
+   workers.clear();
+
+   std::error_code EC;
+   llvm::raw_fd_ostream out(path, EC, llvm::sys::fs::OF_None);
+   if (EC) fatal_error("could not write time trace \"%s\": %s", path, EC.message().c_str());
+   out << value;
+}
+
+extern "C" void timing_finish(const char* output) {
+   if (reporting) print_report();
+
+   if (tracing) {
+      llvm::SmallString<128> path(output);
+      llvm::sys::path::replace_extension(path, "json");
+
+      if (llvm::Error error = llvm::timeTraceProfilerWrite(path, output))
+         fatal_error("could not write time trace \"%s\": %s", path.c_str(), llvm::toString(std::move(error)).c_str());
+      llvm::timeTraceProfilerCleanup();
+      if (!workers.empty()) merge_workers(path.c_str());
+   }
+
+   tracing = false;
+   reporting = false;
+}
\ No newline at end of file
@@ -0,0 +1,67 @@
+/*
+   BLang
+   Copyright (c) 2025 William Gibbs
+
+   This software is provided 'as-is', without any express or implied
+   warranty. In no event will the authors be held liable for any damages
+   arising from the use of this software.
+
+   Permission is granted to anyone to use this software for any purpose,
+   including commercial applications, and to alter it and redistribute it
+   freely, subject to the following restrictions:
+
+   1. The origin of this software must not be misrepresented; you must not
+      claim that you wrote the original software. If you use this software
+      in a product, an acknowledgment in the product documentation would be
+      appreciated but is not required.
+   2. Altered source versions must be plainly marked as such, and must not be
+      misrepresented as being the original software.
+   3. This notice may not be removed or altered from any source distribution.
+*/
+
+#ifndef TIMING_H
+#define TIMING_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Compiler phase timing for -ftime-trace and -ftime-report.
+ *
+ * Phases nest: every timing_begin() is closed by the matching timing_end()
+ * on the same thread. Outside of -ftime-trace and -ftime-report both calls
+ * return immediately.
+ */
+void timing_initialize();
+void timing_begin(const char* name, const char* detail);
+void timing_end();
+
+/**
+ * Work done in too many short pieces to give each its own scope, such as
+ * scanning one token. The caller sums timing_now() differences and hands
+ * the total over once; it becomes a -ftime-report row nested in the open
+ * phase, with `count` pieces. -ftime-trace has no event for it. Both
+ * return immediately (timing_now() returns 0) outside of the two options.
+ */
+double timing_now();
+void timing_record(const char* name, double seconds, unsigned count);
+
+/**
+ * Print the -ftime-report table and write the -ftime-trace JSON next to
+ * `output` (its extension replaced by .json).
+ */
+void timing_finish(const char* output);
+
+/**
+ * Take in the -ftime-trace a worker process wrote to `trace` for `source`
+ * and delete the file. timing_finish() adds its events to this process's
+ * trace, so a multi-file build leaves one trace next to its output.
+ */
+void timing_merge(const char* trace, const char* source);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // TIMING_H
\ No newline at end of file
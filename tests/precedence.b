@@ -0,0 +1,47 @@
+/*
+   BLang
+   Copyright (c) 2025 William Gibbs
+
+   This software is provided 'as-is', without any express or implied
+   warranty. In no event will the authors be held liable for any damages
+   arising from the use of this software.
+
+   Permission is granted to anyone to use this software for any purpose,
+   including commercial applications, and to alter it and redistribute it
+   freely, subject to the following restrictions:
+
+   1. The origin of this software must not be misrepresented; you must not
+      claim that you wrote the original software. If you use this software
+      in a product, an acknowledgment in the product documentation would be
+      appreciated but is not required.
+   2. Altered source versions must be plainly marked as such, and must not be
+      misrepresented as being the original software.
+   3. This notice may not be removed or altered from any source distribution.
+*/
+
+
+/* Operators bind as in C. main() returns the number of the first check that fails, or 0. */
+main() {
+   auto a, b, c;
+
+   a = 2;
+   b = 3;
+
+   /* (a + b) < 4, not a + (b < 4) */
+   if (a + b < 4) return (1);
+
+   /* (-a) <= b, not -(a <= b) */
+   c = -a <= b;
+   if (c != 1) return (2);
+
+   /* (a * b) == 6, not a * (b == 6) */
+   if (a * b == 6) c = 0; else return (3);
+
+   /* (!a) + 1, not !(a + 1) */
+   if (!a + 1 != 1) return (4);
+
+   /* (a - b) - 1, not a - (b - 1) */
+   if (a - b - 1 != -2) return (5);
+
+   return (0);
+}
\ No newline at end of file
@@ -0,0 +1,22 @@
+# Compiles SOURCE with `COMPILER -O2 -emit-llvm` in WORK and fails unless the
+# loop vectorizer turned its loops into SIMD code.
+#
+#    cmake -DCOMPILER=<blang> -DSOURCE=<program.b> -DWORK=<dir> -P vectorize.cmake
+
+file(MAKE_DIRECTORY ${WORK})
+file(REMOVE ${WORK}/output.ll)
+
+execute_process(
+    COMMAND ${COMPILER} -O2 -emit-llvm ${SOURCE}
+    WORKING_DIRECTORY ${WORK}
+    RESULT_VARIABLE status
+)
+if (NOT status EQUAL 0)
+    message(FATAL_ERROR "${COMPILER} -O2 -emit-llvm ${SOURCE} failed")
+endif()
+
+# -emit-llvm always writes output.ll
+file(READ ${WORK}/output.ll ir)
+if (NOT ir MATCHES "<[0-9]+ x i64>" AND NOT ir MATCHES "llvm\\.loop\\.isvectorized")
+    message(FATAL_ERROR "${SOURCE}: no vector types or llvm.loop.isvectorized in the -O2 IR")
+endif()
\ No newline at end of file